@@ -20,8 +20,11 @@
 #ifndef RIPPLE_KEYCACHE_H_INCLUDED
 #define RIPPLE_KEYCACHE_H_INCLUDED
 
+#include <algorithm>
+#include <chrono>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include <boost/smart_ptr.hpp>
 
@@ -29,6 +32,7 @@
 #include "../../beast/beast/chrono/chrono_io.h"
 #include "../../beast/beast/Insight.h"
 #include "../../beast/beast/container/hardened_hash.h"
+#include "SweepCursor.h"
 #include "UnorderedMap.h"
 
 namespace ripple {
@@ -62,6 +66,7 @@ private:
             : hook (collector->make_hook (handler))
             , size (collector->make_gauge (prefix, "size"))
             , hit_rate (collector->make_gauge (prefix, "hit_rate"))
+            , sweep (collector->make_event (prefix, "sweep"))
             , hits (0)
             , misses (0)
             { }
@@ -69,6 +74,7 @@ private:
         beast::insight::Hook hook;
         beast::insight::Gauge size;
         beast::insight::Gauge hit_rate;
+        beast::insight::Event sweep;
 
         std::size_t hits;
         std::size_t misses;
@@ -86,6 +92,7 @@ private:
 
     typedef ripple::unordered_map <key_type, Entry, Hash, KeyEqual> map_type;
     typedef typename map_type::iterator iterator;
+    typedef typename map_type::local_iterator local_iterator;
     typedef std::lock_guard <Mutex> lock_guard;
 
     Mutex mutable m_mutex;
@@ -96,6 +103,17 @@ private:
     unsigned int m_target_size;
     clock_type::duration m_target_age;
 
+    SweepCursor m_sweepCursor;
+
+    enum
+    {
+        // Number of hash buckets examined per lock acquisition in sweep
+        sweepSliceBuckets = 1024
+
+        // Calls to sweep over which a pass through a large table is spread
+        ,sweepCallsPerPass = 4
+    };
+
 public:
     typedef typename map_type::size_type size_type;
 
@@ -242,48 +260,84 @@ public:
         return false;
     }
 
-    /** Remove stale entries from the cache. */
+    /** Remove stale entries from the cache.
+        As with TaggedCache, each call visits a bounded part of the table,
+        continuing where the previous call stopped, and the lock is
+        released between slices of buckets.
+    */
     void sweep ()
     {
+        std::chrono::steady_clock::time_point const start (
+            std::chrono::steady_clock::now ());
+
         clock_type::time_point const now (m_clock.now ());
         clock_type::time_point when_expire;
 
-        lock_guard lock (m_mutex);
-
-        if (m_target_size == 0 ||
-            (m_map.size () <= m_target_size))
         {
-            when_expire = now - m_target_age;
-        }
-        else
-        {
-            when_expire = now - clock_type::duration (
-                m_target_age.count() * m_target_size / m_map.size ());
-
-            clock_type::duration const minimumAge (
-                std::chrono::seconds (1));
-            if (when_expire > (now - minimumAge))
-                when_expire = now - minimumAge;
-        }
-
-        iterator it = m_map.begin ();
+            lock_guard lock (m_mutex);
 
-        while (it != m_map.end ())
-        {
-            if (it->second.last_access > now)
+            if (m_target_size == 0 ||
+                (m_map.size () <= m_target_size))
             {
-                it->second.last_access = now;
-                ++it;
+                when_expire = now - m_target_age;
             }
-            else if (it->second.last_access <= when_expire)
+            else
             {
-                it = m_map.erase (it);
+                when_expire = now - clock_type::duration (
+                    m_target_age.count() * m_target_size / m_map.size ());
+
+                clock_type::duration const minimumAge (
+                    std::chrono::seconds (1));
+                if (when_expire > (now - minimumAge))
+                    when_expire = now - minimumAge;
             }
-            else
+        }
+
+        std::vector <key_type> keysToErase;
+        std::size_t budget (0);
+        bool first (true);
+        bool more (true);
+
+        while (more)
+        {
+            lock_guard lock (m_mutex);
+
+            std::size_t const buckets (m_map.bucket_count ());
+
+            if (first)
+                budget = SweepCursor::budget (
+                    buckets, sweepSliceBuckets, sweepCallsPerPass);
+            first = false;
+
+            // Visiting a key again after a rehash finds it unchanged
+            // or already erased.
+            std::size_t bucket;
+            std::size_t last;
+            more = m_sweepCursor.next (buckets,
+                std::min <std::size_t> (budget, sweepSliceBuckets), bucket, last);
+            budget -= last - bucket;
+            if (budget == 0)
+                more = false;
+
+            for (; bucket < last; ++bucket)
             {
-                ++it;
+                for (local_iterator it (m_map.begin (bucket));
+                    it != m_map.end (bucket); ++it)
+                {
+                    if (it->second.last_access > now)
+                        it->second.last_access = now;
+                    else if (it->second.last_access <= when_expire)
+                        keysToErase.push_back (it->first);
+                }
             }
+
+            for (auto const& key : keysToErase)
+                m_map.erase (key);
+            keysToErase.clear ();
         }
+
+        m_stats.sweep.notify (std::chrono::duration_cast <
+            std::chrono::milliseconds> (std::chrono::steady_clock::now () - start));
     }
 
 private:
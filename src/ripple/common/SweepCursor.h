@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_SWEEPCURSOR_H_INCLUDED
+#define RIPPLE_SWEEPCURSOR_H_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+
+namespace ripple {
+
+/** Remembers where an incremental sweep of a hash table stopped.
+
+    A pass over the table is spread over several calls to sweep, each of
+    which visits a bounded number of buckets, so no single call walks the
+    whole table.
+
+    The cursor is a bucket index, which only means the same thing while
+    the table keeps its bucket count. If the table was rehashed since the
+    last slice, the pass starts over at the first bucket. Otherwise entries
+    moved by the rehash could be skipped for a whole pass. Starting over
+    visits some entries a second time, so a sweep must only act on an
+    entry's current state, which makes a repeated visit do nothing more.
+
+    This class is not thread safe. It is used under the lock which
+    protects the table.
+*/
+class SweepCursor
+{
+public:
+    SweepCursor ()
+        : m_bucket (0)
+        , m_buckets (0)
+    {
+    }
+
+    /** Returns the number of buckets to visit during one call to sweep.
+        At least `sliceBuckets`, and enough to finish a pass over a table
+        of `buckets` buckets in `callsPerPass` calls.
+    */
+    static std::size_t budget (std::size_t buckets,
+        std::size_t sliceBuckets, std::size_t callsPerPass)
+    {
+        return std::max (sliceBuckets,
+            (buckets + callsPerPass - 1) / callsPerPass);
+    }
+
+    /** Claim the next slice of buckets.
+
+        @param buckets The current bucket count of the table.
+        @param count The most buckets to claim.
+        @param first Set to the first bucket to visit.
+        @param last Set to one past the last bucket to visit.
+        @return `false` if this slice finishes the pass. The next slice
+                starts a new pass at the first bucket.
+    */
+    bool next (std::size_t buckets, std::size_t count,
+        std::size_t& first, std::size_t& last)
+    {
+        if (buckets != m_buckets)
+        {
+            m_buckets = buckets;
+            m_bucket = 0;
+        }
+
+        first = m_bucket;
+        last = std::min (buckets, first + count);
+        m_bucket = (last >= buckets) ? 0 : last;
+
+        return m_bucket != 0;
+    }
+
+private:
+    std::size_t m_bucket;
+    std::size_t m_buckets;
+};
+
+}
+
+#endif
@@ -24,9 +24,12 @@
 #include "../../beast/beast/chrono/chrono_io.h"
 #include "../../beast/beast/Insight.h"
 #include "../../beast/beast/container/hardened_hash.h"
+#include "SweepCursor.h"
 
 #include <boost/smart_ptr.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <functional>
 #include <mutex>
 #include <unordered_map>
@@ -162,21 +165,27 @@ public:
         m_cache_count = 0;
     }
 
+    /** Remove expired entries.
+
+        Each call continues where the previous one stopped and visits a
+        bounded part of the table, so a pass over a large cache is spread
+        over several calls. The lock is released between slices of buckets
+        so that lookups and insertions are not held up. A rehash restarts
+        the pass, see SweepCursor.
+    */
     void sweep ()
     {
         int cacheRemovals = 0;
         int mapRemovals = 0;
-        int cc = 0;
+        int slices = 0;
 
-        // Keep references to all the stuff we sweep
-        // so that we can destroy them outside the lock.
-        //
-        std::vector <mapped_ptr> stuffToSweep;
-    
-        {
-            clock_type::time_point const now (m_clock.now());
-            clock_type::time_point when_expire;
+        std::chrono::steady_clock::time_point const start (
+            std::chrono::steady_clock::now ());
+
+        clock_type::time_point const now (m_clock.now());
+        clock_type::time_point when_expire;
 
+        {
             lock_guard lock (m_mutex);
 
             if (m_target_size == 0 ||
@@ -198,59 +207,89 @@ public:
                     m_name << " is growing fast " << m_cache.size () << " of " << m_target_size <<
                         " aging at " << (now - when_expire) << " of " << m_target_age;
             }
+        }
 
-            stuffToSweep.reserve (m_cache.size ());
+        std::vector <key_type> keysToErase;
+        std::size_t budget (0);
+        bool more (true);
 
-            cache_iterator cit = m_cache.begin ();
+        while (more)
+        {
+            // Keep references to all the stuff we sweep
+            // so that we can destroy them outside the lock.
+            //
+            std::vector <mapped_ptr> stuffToSweep;
 
-            while (cit != m_cache.end ())
             {
-                if (cit->second.isWeak ())
-                {
-                    // weak
-                    if (cit->second.isExpired ())
-                    {
-                        ++mapRemovals;
-                        cit = m_cache.erase (cit);
-                    }
-                    else
-                    {
-                        ++cit;
-                    }
-                }
-                else if (cit->second.last_access <= when_expire)
+                lock_guard lock (m_mutex);
+
+                std::size_t const buckets (m_cache.bucket_count ());
+
+                if (slices == 0)
+                    budget = SweepCursor::budget (
+                        buckets, sweepSliceBuckets, sweepCallsPerPass);
+
+                std::size_t bucket;
+                std::size_t last;
+                more = m_sweepCursor.next (buckets,
+                    std::min <std::size_t> (budget, sweepSliceBuckets), bucket, last);
+                budget -= last - bucket;
+                if (budget == 0)
+                    more = false;
+
+                // An entry visited again after a rehash is already weak
+                // or gone, so it is not counted twice.
+                for (; bucket < last; ++bucket)
                 {
-                    // strong, expired
-                    --m_cache_count;
-                    ++cacheRemovals;
-                    if (cit->second.ptr.unique ())
-                    {
-                        stuffToSweep.push_back (cit->second.ptr);
-                        ++mapRemovals;
-                        cit = m_cache.erase (cit);
-                    }
-                    else
+                    for (local_iterator lit (m_cache.begin (bucket));
+                        lit != m_cache.end (bucket); ++lit)
                     {
-                        // remains weakly cached
-                        cit->second.ptr.reset ();
-                        ++cit;
+                        Entry& entry (lit->second);
+
+                        if (entry.isWeak ())
+                        {
+                            // weak
+                            if (entry.isExpired ())
+                                keysToErase.push_back (lit->first);
+                        }
+                        else if (entry.last_access <= when_expire)
+                        {
+                            // strong, expired
+                            --m_cache_count;
+                            ++cacheRemovals;
+                            if (entry.ptr.unique ())
+                            {
+                                stuffToSweep.push_back (entry.ptr);
+                                keysToErase.push_back (lit->first);
+                            }
+                            else
+                            {
+                                // remains weakly cached
+                                entry.ptr.reset ();
+                            }
+                        }
                     }
                 }
-                else
-                {
-                    // strong, not expired
-                    ++cc;
-                    ++cit;
-                }
+
+                // Erasing through the container leaves the bucket
+                // iterators above untouched while we walk them.
+                for (auto const& key : keysToErase)
+                    mapRemovals += m_cache.erase (key);
+                keysToErase.clear ();
+
+                ++slices;
             }
+
+            // At this point stuffToSweep will go out of scope outside the lock
+            // and decrement the reference count on each strong pointer.
         }
 
-        if (m_journal.trace && (mapRemovals || cacheRemovals)) m_journal.trace <<
-            m_name << ": cache = " << m_cache.size () << "-" << cacheRemovals <<
-                ", map-=" << mapRemovals;
+        m_stats.sweep.notify (std::chrono::duration_cast <
+            std::chrono::milliseconds> (std::chrono::steady_clock::now () - start));
 
-        // At this point stuffToSweep will go out of scope outside the lock
-        // and decrement the reference count on each strong pointer.
+        if (m_journal.trace && (mapRemovals || cacheRemovals)) m_journal.trace <<
+            m_name << ": cache = " << getTrackSize () << "-" << cacheRemovals <<
+                ", map-=" << mapRemovals << " in " << slices << " slices";
     }
 
     bool del (const key_type& key, bool valid)
@@ -499,11 +538,13 @@ private:
             : hook (collector->make_hook (handler))
             , size (collector->make_gauge (prefix, "size"))
             , hit_rate (collector->make_gauge (prefix, "hit_rate"))
+            , sweep (collector->make_event (prefix, "sweep"))
             { }
 
         beast::insight::Hook hook;
         beast::insight::Gauge size;
         beast::insight::Gauge hit_rate;
+        beast::insight::Event sweep;
     };
 
     class Entry
@@ -531,6 +572,16 @@ private:
     typedef std::pair <key_type, Entry> cache_pair;
     typedef ripple::unordered_map <key_type, Entry, Hash, KeyEqual> cache_type;
     typedef typename cache_type::iterator cache_iterator;
+    typedef typename cache_type::local_iterator local_iterator;
+
+    enum
+    {
+        // Number of hash buckets examined per lock acquisition in sweep
+        sweepSliceBuckets = 1024
+
+        // Calls to sweep over which a pass through a large table is spread
+        ,sweepCallsPerPass = 4
+    };
 
     beast::Journal m_journal;
     clock_type& m_clock;
@@ -550,6 +601,7 @@ private:
     // Number of items cached
     int m_cache_count;
     cache_type m_cache;  // Hold strong reference to recent objects
+    SweepCursor m_sweepCursor;
     std::uint64_t m_hits;
     std::uint64_t m_misses;
 };
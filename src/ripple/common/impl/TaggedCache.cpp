@@ -143,6 +143,35 @@ public:
             expect (c.getCacheSize() == 0);
             expect (c.getTrackSize() == 0);
         }
+
+        // Fill enough items that a pass takes several calls to sweep,
+        // make sure one call only visits part of them, and that every
+        // one of them is visited by the end of the pass.
+        {
+            int const count (10000);
+            int const callsPerPass (4);
+            for (int i = 0; i < count; ++i)
+                c.insert (100 + i, "many");
+            expect (c.getCacheSize() == count);
+            expect (c.getTrackSize() == count);
+
+            Cache::mapped_ptr p (c.fetch (100));
+            ++clock;
+            c.sweep ();
+            expect (c.getCacheSize() > 0);
+            expect (c.getTrackSize() > 1);
+
+            for (int i = 1; i < callsPerPass; ++i)
+                c.sweep ();
+            expect (c.getCacheSize() == 0);
+            expect (c.getTrackSize() == 1);
+            p.reset ();
+
+            ++clock;
+            for (int i = 0; i < callsPerPass; ++i)
+                c.sweep ();
+            expect (c.getTrackSize() == 0);
+        }
     }
 };
 
@@ -20,9 +20,17 @@
 #ifndef RIPPLE_RADMAP_BASICFULLBELOWCACHE_H_INCLUDED
 #define RIPPLE_RADMAP_BASICFULLBELOWCACHE_H_INCLUDED
 
-#include "../../beast/beast/insight/Collector.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
 
-#include "../../common/KeyCache.h"
+#include "../../../beast/beast/chrono/abstract_clock.h"
+#include "../../../beast/beast/container/hardened_hash.h"
+#include "../../../beast/beast/Insight.h"
 
 #include "Tuning.h"
 
@@ -31,23 +39,102 @@ namespace RadMap {
 
 /** Remembers which tree keys have all descendants resident.
     This optimizes the process of acquiring a complete tree.
+
+    Every inner node visited while synchronizing a tree is looked up here,
+    so lookups take no locks. Keys live in a fixed size table of slots;
+    each key may occupy one of a few neighboring slots, and a new key
+    replaces the oldest of them when they are all in use. Each slot is
+    guarded by its own sequence number, which readers check to detect a
+    concurrent write instead of blocking.
+
+    A slot records the cache generation and the age bucket in which its key
+    was last used. Clearing the cache starts a new generation, which makes
+    every slot stale at once. Age buckets are the clock readings taken by
+    @ref sweep, so keys not used for the expiration time become stale
+    after the next sweep.
 */
-template <class Key>
+template <class Key, class Hash = beast::hardened_hash <Key>>
 class BasicFullBelowCache
 {
-private:
-    typedef KeyCache <Key> CacheType;
-
 public:
     typedef Key key_type;
-    typedef typename CacheType::size_type size_type;
-    typedef typename CacheType::clock_type clock_type;
+    typedef std::size_t size_type;
+    typedef beast::abstract_clock <std::chrono::seconds> clock_type;
+
+private:
+    static_assert (sizeof (Key) % sizeof (std::uint64_t) == 0,
+        "key size must be a multiple of 64 bits");
+
+    // Words needed to hold a key
+    static std::size_t const keyWords = sizeof (Key) / sizeof (std::uint64_t);
+
+    // Slots a key may occupy, starting at the one it hashes to
+    static std::size_t const slotsPerKey = 4;
+
+    // Fewest slots in the table, used when there is no target size
+    static std::size_t const minimumSlots = 32768;
+
+    // Sets of lookup counters, so that threads rarely share one.
+    // Must be a power of two.
+    static std::size_t const counterStripes = 16;
 
+    struct Slot
+    {
+        Slot ()
+            : sequence (0)
+            , stamp (0)
+        {
+            for (std::size_t i = 0; i < keyWords; ++i)
+                key [i].store (0, std::memory_order_relaxed);
+        }
+
+        // Odd while the slot is being written
+        std::atomic <std::uint32_t> sequence;
+
+        // Generation in the high half, age bucket in the low half
+        std::atomic <std::uint64_t> stamp;
+
+        std::atomic <std::uint64_t> key [keyWords];
+    };
+
+    struct Counters
+    {
+        Counters ()
+            : hits (0)
+            , misses (0)
+        {
+        }
+
+        std::atomic <std::uint64_t> hits;
+        std::atomic <std::uint64_t> misses;
+        char pad [64 - 2 * sizeof (std::atomic <std::uint64_t>)];
+    };
+
+    struct Stats
+    {
+        template <class Handler>
+        Stats (std::string const& prefix, Handler const& handler,
+            beast::insight::Collector::ptr const& collector)
+            : hook (collector->make_hook (handler))
+            , size (collector->make_gauge (prefix, "size"))
+            , hit_rate (collector->make_gauge (prefix, "hit_rate"))
+            , sweep (collector->make_event (prefix, "sweep"))
+            { }
+
+        beast::insight::Hook hook;
+        beast::insight::Gauge size;
+        beast::insight::Gauge hit_rate;
+        beast::insight::Event sweep;
+    };
+
+public:
     /** Construct the cache.
 
         @param name A label for diagnostics and stats reporting.
         @param collector The collector to use for reporting stats.
-        @param targetSize The cache target size.
+        @param targetSize The cache target size. The table has twice as
+                          many slots, rounded up to a power of two. They are
+                          allocated up front and each sweep visits all of them.
         @param targetExpirationSeconds The expiration time for items.
     */
     BasicFullBelowCache (std::string const& name, clock_type& clock,
@@ -55,33 +142,72 @@ public:
             beast::insight::NullCollector::New (),
         std::size_t target_size = defaultCacheTargetSize,
         std::size_t expiration_seconds = defaultCacheExpirationSeconds)
-        : m_cache (name, clock, collector, target_size,
-            expiration_seconds)
+        : m_stats (name,
+            std::bind (&BasicFullBelowCache::collect_metrics, this),
+                collector)
+        , m_clock (clock)
+        , m_start (clock.now ())
+        , m_expiration (static_cast <std::uint32_t> (expiration_seconds))
+        , m_slots (tableSize (target_size))
+        , m_mask (m_slots.size () - 1)
+        , m_generation (1)
+        , m_bucket (0)
+        , m_size (0)
     {
     }
 
     /** Return the clock associated with the cache. */
     clock_type& clock()
     {
-        return m_cache.clock ();
+        return m_clock;
     }
 
     /** Return the number of elements in the cache.
+        Keys which have gone stale since the last sweep are included.
         Thread safety:
             Safe to call from any thread.
     */
     size_type size () const
     {
-        return m_cache.size ();
+        return m_size.load (std::memory_order_relaxed);
     }
 
-    /** Remove expired cache items.
+    /** Start a new age bucket, and forget keys which have expired.
         Thread safety:
             Safe to call from any thread.
     */
     void sweep ()
     {
-        m_cache.sweep ();
+        std::chrono::steady_clock::time_point const start (
+            std::chrono::steady_clock::now ());
+
+        m_bucket.store (static_cast <std::uint32_t> (
+            (m_clock.now () - m_start).count ()), std::memory_order_relaxed);
+
+        std::uint64_t const now (current ());
+        std::size_t live (0);
+
+        for (Slot const& slot : m_slots)
+        {
+            if (isLive (slot.stamp.load (std::memory_order_relaxed), now))
+                ++live;
+        }
+
+        m_size.store (live, std::memory_order_relaxed);
+
+        m_stats.sweep.notify (std::chrono::duration_cast <
+            std::chrono::milliseconds> (std::chrono::steady_clock::now () - start));
+    }
+
+    /** Forget every key.
+        This takes constant time; the slots are reused as keys are inserted.
+        Thread safety:
+            Safe to call from any thread.
+    */
+    void clear ()
+    {
+        m_generation.fetch_add (1, std::memory_order_relaxed);
+        m_size.store (0, std::memory_order_relaxed);
     }
 
     /** Refresh the last access time of an item, if it exists.
@@ -92,7 +218,27 @@ public:
     */
     bool touch_if_exists (key_type const& key)
     {
-        return m_cache.touch_if_exists (key);
+        std::uint64_t const now (current ());
+        std::size_t const first (m_hash (key));
+
+        for (std::size_t i = 0; i < slotsPerKey; ++i)
+        {
+            Slot& slot (m_slots [(first + i) & m_mask]);
+            std::uint64_t stamp;
+
+            if (read (slot, key, stamp) && isLive (stamp, now))
+            {
+                // Only write when the age bucket changes, so that
+                // readers of a popular key don't contend
+                if (stamp != now)
+                    slot.stamp.store (now, std::memory_order_relaxed);
+                counters ().hits.fetch_add (1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        counters ().misses.fetch_add (1, std::memory_order_relaxed);
+        return false;
     }
 
     /** Insert a key into the cache.
@@ -104,11 +250,159 @@ public:
     */
     void insert (key_type const& key)
     {
-        m_cache.insert (key);
+        std::uint64_t const now (current ());
+        std::size_t const first (m_hash (key));
+
+        for (;;)
+        {
+            Slot* victim (nullptr);
+            std::uint64_t victimStamp (0);
+            std::uint32_t victimSequence (0);
+
+            for (std::size_t i = 0; i < slotsPerKey; ++i)
+            {
+                Slot& slot (m_slots [(first + i) & m_mask]);
+                std::uint32_t const sequence (
+                    slot.sequence.load (std::memory_order_relaxed));
+                std::uint64_t stamp;
+
+                if (read (slot, key, stamp) && isLive (stamp, now))
+                {
+                    if (stamp != now)
+                        slot.stamp.store (now, std::memory_order_relaxed);
+                    return;
+                }
+
+                if ((sequence & 1) != 0)
+                    continue;
+
+                // Prefer a stale slot, then the least recently used one
+                if (! isLive (stamp, now))
+                    stamp = 0;
+
+                if (victim == nullptr || stamp < victimStamp)
+                {
+                    victim = &slot;
+                    victimStamp = stamp;
+                    victimSequence = sequence;
+                }
+            }
+
+            if (victim == nullptr)
+                continue;
+
+            if (! victim->sequence.compare_exchange_strong (victimSequence,
+                    victimSequence + 1, std::memory_order_acquire))
+                continue;
+
+            std::atomic_thread_fence (std::memory_order_release);
+
+            std::uint64_t words [keyWords];
+            std::memcpy (words, &key, sizeof (Key));
+            for (std::size_t i = 0; i < keyWords; ++i)
+                victim->key [i].store (words [i], std::memory_order_relaxed);
+            victim->stamp.store (now, std::memory_order_relaxed);
+
+            victim->sequence.store (victimSequence + 2, std::memory_order_release);
+
+            if (victimStamp == 0)
+                m_size.fetch_add (1, std::memory_order_relaxed);
+            return;
+        }
     }
 
 private:
-    KeyCache <Key> m_cache;
+    static std::size_t tableSize (std::size_t target_size)
+    {
+        std::size_t const wanted (2 * std::max (target_size, minimumSlots / 2));
+        std::size_t size (1);
+        while (size < wanted)
+            size <<= 1;
+        return size;
+    }
+
+    // Each thread counts in one stripe. Thread ids are often aligned
+    // addresses, so the high bits of the hash are mixed in.
+    Counters& counters ()
+    {
+        std::uint64_t const id (std::hash <std::thread::id> () (
+            std::this_thread::get_id ()));
+        return m_counters [((id * 0x9E3779B97F4A7C15ULL) >> 32) &
+            (counterStripes - 1)];
+    }
+
+    std::uint64_t current () const
+    {
+        return (std::uint64_t (m_generation.load (std::memory_order_relaxed)) << 32) |
+            m_bucket.load (std::memory_order_relaxed);
+    }
+
+    bool isLive (std::uint64_t stamp, std::uint64_t now) const
+    {
+        return ((stamp >> 32) == (now >> 32)) &&
+            (std::uint32_t (now) - std::uint32_t (stamp) < m_expiration);
+    }
+
+    // Returns `true` if the slot holds the key, and retrieves its stamp
+    static bool read (Slot const& slot, key_type const& key, std::uint64_t& stamp)
+    {
+        std::uint64_t words [keyWords];
+        std::memcpy (words, &key, sizeof (Key));
+
+        for (;;)
+        {
+            std::uint32_t const sequence (
+                slot.sequence.load (std::memory_order_acquire));
+
+            bool match (true);
+            stamp = slot.stamp.load (std::memory_order_relaxed);
+            for (std::size_t i = 0; i < keyWords; ++i)
+            {
+                if (slot.key [i].load (std::memory_order_relaxed) != words [i])
+                    match = false;
+            }
+
+            std::atomic_thread_fence (std::memory_order_acquire);
+
+            if (((sequence & 1) == 0) &&
+                (sequence == slot.sequence.load (std::memory_order_relaxed)))
+                return match;
+        }
+    }
+
+    void collect_metrics ()
+    {
+        m_stats.size.set (size ());
+
+        {
+            std::uint64_t hits (0);
+            std::uint64_t misses (0);
+
+            for (Counters const& counters : m_counters)
+            {
+                hits += counters.hits.load (std::memory_order_relaxed);
+                misses += counters.misses.load (std::memory_order_relaxed);
+            }
+
+            beast::insight::Gauge::value_type hit_rate (0);
+            if (hits + misses != 0)
+                hit_rate = (hits * 100) / (hits + misses);
+            m_stats.hit_rate.set (hit_rate);
+        }
+    }
+
+    Stats m_stats;
+    clock_type& m_clock;
+    clock_type::time_point const m_start;
+    std::uint32_t const m_expiration;
+    Hash const m_hash;
+    std::vector <Slot> m_slots;
+    std::size_t const m_mask;
+
+    std::atomic <std::uint32_t> m_generation;
+    std::atomic <std::uint32_t> m_bucket;
+    std::atomic <std::size_t> m_size;
+    Counters m_counters [counterStripes];
 };
 
 }
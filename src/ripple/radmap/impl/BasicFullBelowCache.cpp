@@ -18,11 +18,154 @@
 //==============================================================================
 
 
+#include "../api/BasicFullBelowCache.h"
+
+#include "../../../beast/beast/unit_test/suite.h"
+#include "../../../beast/beast/chrono/manual_clock.h"
+
+#include <thread>
+
 namespace ripple {
 namespace RadMap {
 
-// Unit test to go here if the class becomes
-// a non-trivial wrapper for KeyCache.
+class BasicFullBelowCache_test : public beast::unit_test::suite
+{
+public:
+    typedef BasicFullBelowCache <std::uint64_t> Cache;
+
+    void run ()
+    {
+        beast::manual_clock <std::chrono::seconds> clock;
+        clock.set (0);
+
+        // Insert an item, retrieve it, and age it so it gets purged.
+        {
+            Cache c ("test", clock, beast::insight::NullCollector::New (), 1, 2);
+
+            expect (c.size () == 0);
+            expect (! c.touch_if_exists (1));
+            c.insert (1);
+            c.insert (1);
+            expect (c.size () == 1);
+            expect (c.touch_if_exists (1));
+            ++clock;
+            c.sweep ();
+            expect (c.size () == 1);
+            expect (c.touch_if_exists (1));
+            ++clock;
+            c.sweep ();
+            expect (c.size () == 1);
+            ++clock;
+            c.sweep ();
+            expect (c.size () == 0);
+            expect (! c.touch_if_exists (1));
+        }
+
+        // Insert two items, have one expire
+        {
+            Cache c ("test", clock, beast::insight::NullCollector::New (), 2, 2);
+
+            c.insert (1);
+            c.insert (2);
+            expect (c.size () == 2);
+            ++clock;
+            c.sweep ();
+            expect (c.touch_if_exists (2));
+            ++clock;
+            c.sweep ();
+            expect (c.size () == 1);
+            expect (c.touch_if_exists (2));
+            expect (! c.touch_if_exists (1));
+        }
+
+        // Clearing forgets everything, and the slots are reused
+        {
+            Cache c ("test", clock);
+
+            for (std::uint64_t i = 0; i < 1000; ++i)
+                c.insert (i);
+            expect (c.size () == 1000);
+            c.clear ();
+            expect (c.size () == 0);
+            expect (! c.touch_if_exists (500));
+            c.insert (500);
+            expect (c.touch_if_exists (500));
+            c.sweep ();
+            expect (c.size () == 1);
+        }
+
+        // Overfilling the table replaces keys instead of growing it
+        {
+            Cache c ("test", clock);
+
+            for (std::uint64_t i = 0; i < 1000000; ++i)
+                c.insert (i);
+            c.sweep ();
+            expect (c.size () <= 65536);
+            expect (c.touch_if_exists (999999));
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(BasicFullBelowCache,radmap,ripple);
+
+//------------------------------------------------------------------------------
+
+// Measures lookups from many threads, as when several trees are acquired
+class BasicFullBelowCache_timing_test : public beast::unit_test::suite
+{
+public:
+    typedef BasicFullBelowCache <std::uint64_t> Cache;
+
+    void run ()
+    {
+        beast::manual_clock <std::chrono::seconds> clock;
+        Cache c ("test", clock, beast::insight::NullCollector::New (), 65536, 600);
+
+        std::uint64_t const keys = 65536;
+        for (std::uint64_t i = 0; i < keys; i += 2)
+            c.insert (i);
+
+        std::size_t const lookups = 4000000;
+        unsigned const threads = std::max (2u, std::thread::hardware_concurrency ());
+
+        for (unsigned n = 1; n <= threads; n *= 2)
+        {
+            std::atomic <std::size_t> found (0);
+            std::chrono::steady_clock::time_point const start (
+                std::chrono::steady_clock::now ());
+
+            std::vector <std::thread> workers;
+            for (unsigned t = 0; t < n; ++t)
+            {
+                workers.emplace_back ([&c, &found, t, keys, lookups, n]
+                {
+                    std::size_t hits (0);
+                    for (std::size_t i = 0; i < lookups / n; ++i)
+                    {
+                        if (c.touch_if_exists ((i * 7 + t) % keys))
+                            ++hits;
+                    }
+                    found += hits;
+                });
+            }
+
+            for (auto& worker : workers)
+                worker.join ();
+
+            std::chrono::milliseconds const elapsed (
+                std::chrono::duration_cast <std::chrono::milliseconds> (
+                    std::chrono::steady_clock::now () - start));
+
+            log <<
+                n << " threads, " << lookups << " lookups in " <<
+                elapsed.count () << "ms";
+            expect (found > 0);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(BasicFullBelowCache_timing,radmap,ripple);
 
 }
 }
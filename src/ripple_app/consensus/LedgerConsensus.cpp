@@ -33,6 +33,17 @@ class LedgerConsensusImp
 public:
     enum {resultSuccess, resultFail, resultRetry};
 
+    enum
+    {
+        // Pending node store writes above which accepting a ledger waits
+        backloggedWriteLoad = 8192
+
+        // Longest wait per accepted ledger, in milliseconds
+        ,backloggedWaitMillis = 50
+
+        ,backloggedPollMillis = 5
+    };
+
     static char const* getCountedObjectName () { return "LedgerConsensus"; }
 
     LedgerConsensusImp (clock_type& clock, LocalTxs& localtx,
@@ -53,6 +64,8 @@ public:
         , mHaveCloseTimeConsensus (false)
         , mConsensusStartTime 
             (boost::posix_time::microsec_clock::universal_time ())
+        , mDeltasBuilt (0)
+        , mDeltasMissed (0)
     {
         WriteLog (lsDEBUG, LedgerConsensus) << "Creating consensus object";
         WriteLog (lsTRACE, LedgerConsensus) 
@@ -160,6 +173,13 @@ public:
             ret["previous_proposers"] = mPreviousProposers;
             ret["previous_mseconds"] = mPreviousMSeconds;
 
+            if ((mDeltasBuilt != 0) || (mDeltasMissed != 0))
+            {
+                Json::Value& deltas = (ret["set_deltas"] = Json::objectValue);
+                deltas["built"] = mDeltasBuilt;
+                deltas["missed"] = mDeltasMissed;
+            }
+
             if (!mPeerPositions.empty ())
             {
                 typedef ripple::unordered_map<uint160, 
@@ -769,7 +789,13 @@ public:
         currentPosition = newPosition;
 
         SHAMap::pointer set 
-            = getTransactionTree (newPosition->getCurrentHash (), true);
+            = getTransactionTree (newPosition->getCurrentHash (), false);
+
+        if (!set && buildFromDelta (newPosition))
+            set = getTransactionTree (newPosition->getCurrentHash (), false);
+
+        if (!set)
+            set = getTransactionTree (newPosition->getCurrentHash (), true);
 
         if (set)
         {
@@ -787,6 +813,110 @@ public:
         return true;
     }
 
+    /** Try to build a peer's proposed set from a set we already have
+        and the changes the peer listed, so that it need not be acquired.
+    */
+    bool buildFromDelta (LedgerProposal::ref position)
+    {
+        if (!position->hasDelta ())
+            return false;
+
+        SHAMap::pointer set;
+
+        if (position->getDeltaBase ().isZero ())
+        {
+            set = boost::make_shared<SHAMap> (
+                smtTRANSACTION, std::ref (getApp().getFullBelowCache()));
+        }
+        else
+        {
+            ripple::unordered_map<uint256, SHAMap::pointer>::iterator it
+                = mAcquired.find (position->getDeltaBase ());
+
+            if ((it == mAcquired.end ()) || !it->second)
+            {
+                ++mDeltasMissed;
+                return false;
+            }
+
+            set = it->second->snapShot (true);
+        }
+
+        BOOST_FOREACH (uint256 const& txID, position->getRemoved ())
+        {
+            if (!set->delItem (txID))
+            {
+                ++mDeltasMissed;
+                return false;
+            }
+        }
+
+        BOOST_FOREACH (uint256 const& txID, position->getAdded ())
+        {
+            SHAMapItem::pointer item = findTransaction (txID);
+
+            if (!item || !set->addItem (*item, true, false))
+            {
+                // The acquire will only fetch what we lack
+                WriteLog (lsDEBUG, LedgerConsensus)
+                    << "Set delta needs unknown transaction " << txID;
+                ++mDeltasMissed;
+                return false;
+            }
+        }
+
+        if (set->getHash () != position->getCurrentHash ())
+        {
+            WriteLog (lsWARNING, LedgerConsensus)
+                << "Set delta does not produce " << position->getCurrentHash ();
+            ++mDeltasMissed;
+            return false;
+        }
+
+        WriteLog (lsDEBUG, LedgerConsensus)
+            << "Built TXS " << position->getCurrentHash () << " from delta";
+        ++mDeltasBuilt;
+        mapComplete (position->getCurrentHash (), set, false);
+        return true;
+    }
+
+    /** Find a transaction we already know of, as a transaction set item
+    */
+    SHAMapItem::pointer findTransaction (uint256 const& txID)
+    {
+        typedef ripple::unordered_map<uint256, SHAMap::pointer>::value_type
+            u256_map_pair;
+        BOOST_FOREACH (u256_map_pair & it, mAcquired)
+        {
+            if (it.second)
+            {
+                SHAMapItem::pointer item = it.second->peekItem (txID);
+
+                if (item)
+                    return item;
+            }
+        }
+
+        ripple::unordered_map<uint256, DisputedTx::pointer>::iterator dit
+            = mDisputes.find (txID);
+
+        if (dit != mDisputes.end ())
+            return boost::make_shared<SHAMapItem> (
+                txID, dit->second->peekTransaction ());
+
+        Transaction::pointer txn
+            = getApp().getMasterTransaction ().fetch (txID, false);
+
+        if (txn)
+        {
+            Serializer s;
+            txn->getSTransaction ()->add (s);
+            return boost::make_shared<SHAMapItem> (txID, s);
+        }
+
+        return SHAMapItem::pointer ();
+    }
+
     /** A peer has informed us that it can give us a transaction set
     */
     bool peerHasSet (Peer::ptr const& peer, uint256 const& hashSet
@@ -815,7 +945,7 @@ public:
     /** A peer has sent us some nodes from a transaction set
     */
     SHAMapAddNode peerGaveNodes (Peer::ptr const& peer
-        , uint256 const& setHash, const std::list<SHAMapNode>& nodeIDs
+        , uint256 const& setHash, const std::vector<SHAMapNode>& nodeIDs
         , const std::list< Blob >& nodeData)
     {
         ripple::unordered_map<uint256
@@ -850,6 +980,39 @@ public:
         WriteLog (lsINFO, LedgerConsensus) << "Simulation complete";
     }
 private:
+    /** Give a backlogged node store a chance to catch up.
+
+        This waits a bounded time, once per ledger and without the master
+        lock held, so the dirty nodes of a fast stream of ledgers do
+        not pile up faster than the backend can write them. It takes the
+        place of a per-batch wait in SHAMap::flushDirty, which would run
+        with the master lock held.
+    */
+    void waitForNodeStore ()
+    {
+        NodeStore::Database& nodeStore (getApp().getNodeStore ());
+        int waited = 0;
+
+        while ((waited < backloggedWaitMillis) &&
+            (nodeStore.getWriteLoad () > backloggedWriteLoad))
+        {
+            std::this_thread::sleep_for (
+                std::chrono::milliseconds (backloggedPollMillis));
+            waited += backloggedPollMillis;
+        }
+
+        CondLog (waited != 0, lsDEBUG, LedgerConsensus)
+            << "Waited " << waited << "ms for node store writes";
+    }
+
+    /** Accept from the job queue, where waiting holds up no locks.
+    */
+    void acceptJob (SHAMap::pointer set)
+    {
+        waitForNodeStore ();
+        accept (set);
+    }
+
     /** We have a new last closed ledger, process it. Final accept logic
     */
     void accept (SHAMap::pointer set)
@@ -1003,10 +1166,9 @@ private:
                         WriteLog (lsDEBUG, LedgerConsensus) 
                             << "Test applying disputed transaction that did"
                             << " not get in";
-                        SerializerIterator sit (it.second->peekTransaction ());
                         SerializedTransaction::pointer txn 
-                            = boost::make_shared<SerializedTransaction> 
-                            (boost::ref (sit));
+                            = getApp().getMasterTransaction ().fetchParsed (
+                                it.first, it.second->peekTransaction ());
 
                         if (applyTransaction (engine, txn, newOL, true, false))
                         {
@@ -1253,9 +1415,82 @@ private:
         Blob sig = mOurPosition->sign ();
         prop.set_nodepubkey (&pubKey[0], pubKey.size ());
         prop.set_signature (&sig[0], sig.size ());
-        getApp ().overlay ().foreach (send_always (
-            boost::make_shared<Message> (
-                prop, protocol::mtPROPOSE_LEDGER)));
+
+        Message::pointer const message (boost::make_shared<Message> (
+            prop, protocol::mtPROPOSE_LEDGER));
+
+        if (addSetDelta (prop))
+        {
+            // Peers that understand deltas can rebuild our set locally
+            Message::pointer const deltaMessage (boost::make_shared<Message> (
+                prop, protocol::mtPROPOSE_LEDGER));
+            getApp ().overlay ().foreach (send_if (
+                deltaMessage, peer_takes_set_deltas ()));
+            getApp ().overlay ().foreach (send_if_not (
+                message, peer_takes_set_deltas ()));
+        }
+        else
+        {
+            getApp ().overlay ().foreach (send_always (message));
+        }
+
+        if (!mOurPosition->isBowOut ())
+            mProposedSet = mOurPosition->getCurrentHash ();
+    }
+
+    /** List the transactions our position adds and removes relative
+        to the set we last proposed. Returns `false` if the list would
+        not help peers.
+    */
+    bool addSetDelta (protocol::TMProposeSet& prop)
+    {
+        uint256 const& current (mOurPosition->getCurrentHash ());
+
+        if (mOurPosition->isBowOut () || current.isZero () ||
+            (current == mProposedSet))
+            return false;
+
+        ripple::unordered_map<uint256, SHAMap::pointer>::iterator it
+            = mAcquired.find (current);
+
+        if ((it == mAcquired.end ()) || !it->second)
+            return false;
+
+        SHAMap::pointer base;
+
+        if (mProposedSet.isZero ())
+        {
+            base = boost::make_shared<SHAMap> (
+                smtTRANSACTION, std::ref (getApp().getFullBelowCache()));
+        }
+        else
+        {
+            ripple::unordered_map<uint256, SHAMap::pointer>::iterator bit
+                = mAcquired.find (mProposedSet);
+
+            if ((bit == mAcquired.end ()) || !bit->second)
+                return false;
+
+            base = bit->second;
+        }
+
+        SHAMap::Delta differences;
+
+        if (!base->compare (it->second, differences, LedgerProposal::maxSetDelta))
+            return false;
+
+        BOOST_FOREACH (SHAMap::Delta::value_type const& diff, differences)
+        {
+            if (diff.second.second)
+                prop.add_addedtransactions (diff.first.begin (), 256 / 8);
+            else
+                prop.add_removedtransactions (diff.first.begin (), 256 / 8);
+        }
+
+        if (mProposedSet.isNonZero ())
+            prop.set_previoustxhash (mProposedSet.begin (), 256 / 8);
+
+        return true;
     }
 
     /** Let peers know that we a particular transactions set so they
@@ -1290,10 +1525,9 @@ private:
                 try
                 {
 #endif
-                    SerializerIterator sit (item->peekSerializer ());
                     SerializedTransaction::pointer txn 
-                        = boost::make_shared<SerializedTransaction> 
-                        (boost::ref (sit));
+                        = getApp().getMasterTransaction ().fetchParsed (
+                            item->getTag (), item->peekSerializer ());
 
                     if (applyTransaction (engine, txn, 
                         applyLedger, openLgr, true) == resultRetry)
@@ -1707,10 +1941,11 @@ private:
 
             if (mOurPosition->changePosition (newHash, closeTime))
             {
+                // The new set must be known before we propose a delta to it
+                mapComplete (newHash, ourPosition, false);
+
                 if (mProposing)
                     propose ();
-
-                mapComplete (newHash, ourPosition, false);
             }
         }
     }
@@ -1866,7 +2101,7 @@ private:
         else
         {
             getApp().getJobQueue().addJob (jtACCEPT, "acceptLedger",
-                BIND_TYPE (&LedgerConsensusImp::accept, shared_from_this (), consensusSet));
+                BIND_TYPE (&LedgerConsensusImp::acceptJob, shared_from_this (), consensusSet));
         }
     }
 
@@ -1937,6 +2172,13 @@ private:
 
     // nodes that have bowed out of this consensus process
     boost::unordered_set<uint160> mDeadNodes;
+
+    // The transaction set in our last proposal
+    uint256 mProposedSet;
+
+    // Peer sets rebuilt from proposal deltas, and deltas we could not use
+    int mDeltasBuilt;
+    int mDeltasMissed;
 };
 
 //------------------------------------------------------------------------------
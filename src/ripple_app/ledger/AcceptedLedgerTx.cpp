@@ -19,14 +19,14 @@
 
 namespace ripple {
 
-AcceptedLedgerTx::AcceptedLedgerTx (std::uint32_t seq, SerializerIterator& sit)
+AcceptedLedgerTx::AcceptedLedgerTx (uint256 const& txID, std::uint32_t seq,
+    SerializerIterator& sit)
 {
     Serializer          txnSer (sit.getVL ());
-    SerializerIterator  txnIt (txnSer);
 
-    mTxn =      boost::make_shared<SerializedTransaction> (boost::ref (txnIt));
+    mTxn =      getApp().getMasterTransaction ().fetchParsed (txID, txnSer);
     mRawMeta =  sit.getVL ();
-    mMeta =     boost::make_shared<TransactionMetaSet> (mTxn->getTransactionID (), seq, mRawMeta);
+    mMeta =     boost::make_shared<TransactionMetaSet> (txID, seq, mRawMeta);
     mAffected = mMeta->getAffectedAccounts ();
     mResult =   mMeta->getResultTER ();
     buildJson ();
@@ -48,7 +48,8 @@ public:
     typedef const pointer& ref;
 
 public:
-    AcceptedLedgerTx (LedgerIndex ledgerSeq, SerializerIterator& sit);
+    AcceptedLedgerTx (uint256 const& txID, LedgerIndex ledgerSeq,
+        SerializerIterator& sit);
     AcceptedLedgerTx (SerializedTransaction::ref, TransactionMetaSet::ref);
     AcceptedLedgerTx (SerializedTransaction::ref, TER result);
 
@@ -34,6 +34,15 @@ enum
 
     // how many timeouts before we get aggressive
     ,ledgerBecomeAggressiveThreshold = 6
+
+    // how many missing nodes to look for in each map per trigger
+    ,ledgerMaxNodeRequest = 256
+
+    // how many when the node store is behind on writes
+    ,ledgerBackloggedNodeRequest = 32
+
+    // pending node store writes above which we are behind
+    ,ledgerBackloggedWriteLoad = 8192
 };
 
 InboundLedger::InboundLedger (uint256 const& hash, std::uint32_t seq, fcReason reason,
@@ -45,6 +54,7 @@ InboundLedger::InboundLedger (uint256 const& hash, std::uint32_t seq, fcReason r
     , mHaveTransactions (false)
     , mAborted (false)
     , mSignaled (false)
+    , mShed (false)
     , mByHash (true)
     , mSeq (seq)
     , mReason (reason)
@@ -269,6 +279,20 @@ void InboundLedger::onTimer (bool wasProgress, ScopedLockType&)
     }
 }
 
+/** The number of missing nodes to request at once.
+    When the node store falls behind on writes, ledgers which are only
+    wanted for history ask for fewer nodes, so that acquiring them doesn't
+    add to the backlog faster than it drains.
+*/
+int InboundLedger::getMaxNodeRequest () const
+{
+    if ((mReason == fcHISTORY) && (getApp().getNodeStore ().getWriteLoad () >
+        ledgerBackloggedWriteLoad))
+        return ledgerBackloggedNodeRequest;
+
+    return ledgerMaxNodeRequest;
+}
+
 /** Add more peers to the set, if possible */
 void InboundLedger::addPeers ()
 {
@@ -359,6 +383,9 @@ static void LADispatch (
     }
     for (unsigned int i = 0; i < trig.size (); ++i)
         trig[i] (la);
+
+    // A slot is free, start any acquisition that was waiting for one
+    getApp().getInboundLedgers().admitPending ();
 }
 
 void InboundLedger::done ()
@@ -386,7 +413,7 @@ void InboundLedger::done ()
         mLedger->setImmutable ();
         getApp().getLedgerMaster ().storeLedger (mLedger);
     }
-    else
+    else if (!mShed)
         getApp().getInboundLedgers ().logFailure (mHash);
 
     // We hold the PeerSet lock, so must dispatch
@@ -394,6 +421,17 @@ void InboundLedger::done ()
         BIND_TYPE (LADispatch, P_1, shared_from_this (), triggers));
 }
 
+void InboundLedger::shed ()
+{
+    {
+        ScopedLockType sl (mLock);
+        mShed = true;
+        setFailed ();
+    }
+
+    done ();
+}
+
 bool InboundLedger::addOnComplete (
     std::function <void (InboundLedger::pointer)> triggerFunc)
 {
@@ -553,15 +591,15 @@ void InboundLedger::trigger (Peer::ptr const& peer)
         {
             std::vector<SHAMapNode> nodeIDs;
             std::vector<uint256> nodeHashes;
-            // VFALCO Why 256? Make this a constant
-            nodeIDs.reserve (256);
-            nodeHashes.reserve (256);
+            int const maxNodes (getMaxNodeRequest ());
+            nodeIDs.reserve (maxNodes);
+            nodeHashes.reserve (maxNodes);
             AccountStateSF filter (mSeq);
 
             // Release the lock while we process the large state map
             sl.unlock();
             mLedger->peekAccountStateMap ()->getMissingNodes (
-                nodeIDs, nodeHashes, 256, &filter);
+                nodeIDs, nodeHashes, maxNodes, &filter);
             sl.lock();
 
             // Make sure nothing happened while we released the lock
@@ -629,11 +667,12 @@ void InboundLedger::trigger (Peer::ptr const& peer)
         {
             std::vector<SHAMapNode> nodeIDs;
             std::vector<uint256> nodeHashes;
-            nodeIDs.reserve (256);
-            nodeHashes.reserve (256);
+            int const maxNodes (getMaxNodeRequest ());
+            nodeIDs.reserve (maxNodes);
+            nodeHashes.reserve (maxNodes);
             TransactionStateSF filter (mSeq);
             mLedger->peekTransactionMap ()->getMissingNodes (
-                nodeIDs, nodeHashes, 256, &filter);
+                nodeIDs, nodeHashes, maxNodes, &filter);
 
             if (nodeIDs.empty ())
             {
@@ -686,7 +725,7 @@ void InboundLedger::trigger (Peer::ptr const& peer)
 }
 
 void InboundLedger::filterNodes (std::vector<SHAMapNode>& nodeIDs,
-    std::vector<uint256>& nodeHashes, std::set<SHAMapNode>& recentNodes,
+    std::vector<uint256>& nodeHashes, NodeSet& recentNodes,
     int max, bool aggressive)
 {
     // ask for new nodes in preference to ones we've already asked for
@@ -807,7 +846,7 @@ bool InboundLedger::takeBase (const std::string& data)
 /** Process TX data received from a peer
     Call with a lock
 */
-bool InboundLedger::takeTxNode (const std::list<SHAMapNode>& nodeIDs,
+bool InboundLedger::takeTxNode (const std::vector<SHAMapNode>& nodeIDs,
     const std::list< Blob >& data, SHAMapAddNode& san)
 {
     if (!mHaveBase)
@@ -824,7 +863,7 @@ bool InboundLedger::takeTxNode (const std::list<SHAMapNode>& nodeIDs,
         return true;
     }
 
-    std::list<SHAMapNode>::const_iterator nodeIDit = nodeIDs.begin ();
+    std::vector<SHAMapNode>::const_iterator nodeIDit = nodeIDs.begin ();
     std::list< Blob >::const_iterator nodeDatait = data.begin ();
     TransactionStateSF tFilter (mLedger->getLedgerSeq ());
 
@@ -867,7 +906,7 @@ bool InboundLedger::takeTxNode (const std::list<SHAMapNode>& nodeIDs,
 /** Process AS data received from a peer
     Call with a lock
 */
-bool InboundLedger::takeAsNode (const std::list<SHAMapNode>& nodeIDs,
+bool InboundLedger::takeAsNode (const std::vector<SHAMapNode>& nodeIDs,
     const std::list< Blob >& data, SHAMapAddNode& san)
 {
     if (m_journal.trace) m_journal.trace <<
@@ -891,7 +930,7 @@ bool InboundLedger::takeAsNode (const std::list<SHAMapNode>& nodeIDs,
         return true;
     }
 
-    std::list<SHAMapNode>::const_iterator nodeIDit = nodeIDs.begin ();
+    std::vector<SHAMapNode>::const_iterator nodeIDit = nodeIDs.begin ();
     std::list< Blob >::const_iterator nodeDatait = data.begin ();
     AccountStateSF tFilter (mLedger->getLedgerSeq ());
 
@@ -1110,7 +1149,7 @@ int InboundLedger::processData (boost::shared_ptr<Peer> peer,
     if ((packet.type () == protocol::liTX_NODE) || (
         packet.type () == protocol::liAS_NODE))
     {
-        std::list<SHAMapNode> nodeIDs;
+        std::vector<SHAMapNode> nodeIDs;
         std::list< Blob > nodeData;
 
         if (packet.nodes ().size () == 0)
@@ -1121,6 +1160,8 @@ int InboundLedger::processData (boost::shared_ptr<Peer> peer,
             return -1;
         }
 
+        nodeIDs.reserve (packet.nodes ().size ());
+
         for (int i = 0; i < packet.nodes ().size (); ++i)
         {
             const protocol::TMLedgerNode& node = packet.nodes (i);
@@ -20,6 +20,8 @@
 #ifndef RIPPLE_INBOUNDLEDGER_H
 #define RIPPLE_INBOUNDLEDGER_H
 
+#include <unordered_set>
+
 namespace ripple {
 
 // VFALCO TODO Rename to InboundLedger
@@ -34,12 +36,14 @@ public:
 
     typedef boost::shared_ptr <InboundLedger> pointer;
     typedef std::pair < boost::weak_ptr<Peer>, boost::shared_ptr<protocol::TMLedgerData> > PeerDataPairType;
+    typedef std::unordered_set <SHAMapNode, SHAMapNode_hash> NodeSet;
 
     // These are the reasons we might acquire a ledger
     enum fcReason
     {
         fcHISTORY,      // Acquiring past ledger
         fcGENERIC,      // Generic other reasons
+        fcPUBLISH,      // A validated ledger we need in order to publish it
         fcVALIDATION,   // Validations suggest this ledger is important
         fcCURRENT,      // This might be the current ledger
         fcCONSENSUS,    // We believe the consensus round requires this ledger
@@ -74,10 +78,25 @@ public:
     {
         mAborted = true;
     }
+    /** Give up on an acquisition which was never started.
+        It is marked failed and its callbacks are run. Since it was never
+        tried, it is not recorded as a recent failure and may be acquired
+        again right away.
+    */
+    void shed ();
     std::uint32_t getSeq ()
     {
         return mSeq;
     }
+    fcReason getReason () const
+    {
+        return mReason;
+    }
+    /** Raise the priority of an acquisition which has not started yet. */
+    void setReason (fcReason reason)
+    {
+        mReason = reason;
+    }
 
     // VFALCO TODO Make this the Listener / Observer pattern
     bool addOnComplete (std::function<void (InboundLedger::pointer)>);
@@ -96,7 +115,7 @@ public:
 
     // VFALCO TODO Replace uint256 with something semanticallyh meaningful
     void filterNodes (std::vector<SHAMapNode>& nodeIDs, std::vector<uint256>& nodeHashes,
-                             std::set<SHAMapNode>& recentNodes, int max, bool aggressive);
+                             NodeSet& recentNodes, int max, bool aggressive);
 
     Json::Value getJson (int);
     void runData ();
@@ -106,6 +125,8 @@ private:
 
     void onTimer (bool progress, ScopedLockType& peerSetLock);
 
+    int getMaxNodeRequest () const;
+
     void newPeer (Peer::ptr const& peer)
     {
         trigger (peer);
@@ -116,7 +137,7 @@ private:
     int processData (boost::shared_ptr<Peer> peer, protocol::TMLedgerData& data);
 
     bool takeBase (const std::string& data);
-    bool takeTxNode (const std::list<SHAMapNode>& IDs, const std::list<Blob >& data,
+    bool takeTxNode (const std::vector<SHAMapNode>& IDs, const std::list<Blob >& data,
                      SHAMapAddNode&);
     bool takeTxRootNode (Blob const& data, SHAMapAddNode&);
 
@@ -124,7 +145,7 @@ private:
     //             Don't use acronyms, but if we are going to use them at least
     //             capitalize them correctly.
     //
-    bool takeAsNode (const std::list<SHAMapNode>& IDs, const std::list<Blob >& data,
+    bool takeAsNode (const std::vector<SHAMapNode>& IDs, const std::list<Blob >& data,
                      SHAMapAddNode&);
     bool takeAsRootNode (Blob const& data, SHAMapAddNode&);
 
@@ -135,12 +156,13 @@ private:
     bool               mHaveTransactions;
     bool               mAborted;
     bool               mSignaled;
+    bool               mShed;
     bool               mByHash;
     std::uint32_t      mSeq;
     fcReason           mReason;
 
-    std::set <SHAMapNode> mRecentTXNodes;
-    std::set <SHAMapNode> mRecentASNodes;
+    NodeSet mRecentTXNodes;
+    NodeSet mRecentASNodes;
 
 
     // Data we have received from peers
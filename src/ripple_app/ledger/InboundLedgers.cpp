@@ -29,6 +29,15 @@ public:
     // How long before we try again to acquire the same ledger
     static const int kReacquireIntervalSeconds = 300;
 
+    // How many acquisitions may wait for a free slot
+    static const std::size_t kMaxPending = 512;
+
+    // Calls to sweep over which a pass through the ledgers is spread
+    static const std::size_t kSweepCallsPerPass = 4;
+
+    // Fewest hash buckets examined by one call to sweep
+    static const std::size_t kSweepSliceBuckets = 64;
+
     InboundLedgersImp (clock_type& clock, Stoppable& parent,
                        beast::insight::Collector::ptr const& collector)
         : Stoppable ("InboundLedgers", parent)
@@ -36,6 +45,9 @@ public:
         , mRecentFailures ("LedgerAcquireRecentFailures",
             clock, 0, kReacquireIntervalSeconds)
         , mCounter(collector->make_counter("ledger_fetches"))
+        , mAdmitted (0)
+        , mDeferred (0)
+        , mShed (0)
     {
     }
 
@@ -48,6 +60,8 @@ public:
 
         // Ensure that any previous IL is destroyed outside the lock
         InboundLedger::pointer oldLedger;
+        InboundLedger::pointer shedLedger;
+        bool deferred = false;
 
         {
             ScopedLockType sl (mLock);
@@ -64,6 +78,7 @@ public:
 			{
 			    oldLedger = it->second;
 			    mLedgers.erase (it);
+			    erasePending (oldLedger->getHash ());
 		       }
 		    }
 		    mConsensusLedger = hash;
@@ -77,6 +92,7 @@ public:
 			{
 			    oldLedger = it->second;
 			    mLedgers.erase (it);
+			    erasePending (oldLedger->getHash ());
 		       }
 		    }
 		    mValidationLedger = hash;
@@ -87,18 +103,151 @@ public:
                 {
                     ret = it->second;
                     // FIXME: Should set the sequence if it's not set
+
+                    // A waiting request takes the most urgent reason it was asked for
+                    PendingIndex::iterator const pending (mPendingIndex.find (hash));
+                    if ((pending != mPendingIndex.end ()) &&
+                        (reason > pending->second->reason))
+                    {
+                        Pending entry (*pending->second);
+                        entry.reason = reason;
+                        ret->setReason (reason);
+                        mPending.erase (pending->second);
+                        pending->second = mPending.insert (entry).first;
+                        deferred = true;
+                    }
                 }
                 else
                 {
                     ret = boost::make_shared <InboundLedger> (hash, seq, reason, std::ref (m_clock));
                     assert (ret);
                     mLedgers.insert (std::make_pair (hash, ret));
-                    ret->init (sl);
-                    ++mCounter;
+
+                    if (canStart (reason, countActive ()))
+                    {
+                        ++mAdmitted;
+                        ret->init (sl);
+                        ++mCounter;
+                    }
+                    else
+                    {
+                        Pending const entry (reason, seq, hash);
+                        mPendingIndex[hash] = mPending.insert (entry).first;
+                        ++mDeferred;
+                        deferred = true;
+
+                        if (mPending.size () > kMaxPending)
+                        {
+                            // Forget the least important request, which may be this one
+                            uint256 const shed (mPending.rbegin ()->hash);
+                            MapType::iterator const found (mLedgers.find (shed));
+                            if (found != mLedgers.end ())
+                            {
+                                shedLedger = found->second;
+                                mLedgers.erase (found);
+                            }
+                            erasePending (shed);
+                            ++mShed;
+
+                            // The new request was never started, so it is not returned
+                            if (shed == hash)
+                                ret.reset ();
+                        }
+                    }
                 }
             }
         }
 
+        // Anyone waiting on a shed acquisition is told it failed
+        if (shedLedger)
+            shedLedger->shed ();
+
+        if (deferred)
+            admitPending ();
+
+        return ret;
+    }
+
+    void admitPending ()
+    {
+        std::vector <InboundLedger::pointer> admitted;
+
+        {
+            ScopedLockType sl (mLock);
+
+            if (mPending.empty () || isStopping ())
+                return;
+
+            ActiveCounts active (countActive ());
+            PendingSet::iterator it (mPending.begin ());
+
+            while (it != mPending.end ())
+            {
+                if (canStart (it->reason, active))
+                {
+                    MapType::iterator const found (mLedgers.find (it->hash));
+                    if (found != mLedgers.end ())
+                        admitted.push_back (found->second);
+                    ++active[it->reason];
+                    ++mAdmitted;
+                    mPendingIndex.erase (it->hash);
+                    it = mPending.erase (it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        BOOST_FOREACH (InboundLedger::pointer const& ledger, admitted)
+        {
+            ScopedLockType sl (mLock);
+
+            // It may have been dropped or finished since it left the queue
+            MapType::iterator const found (mLedgers.find (ledger->getHash ()));
+            if ((found == mLedgers.end ()) || (found->second != ledger) || ledger->isDone ())
+                continue;
+
+            WriteLog (lsDEBUG, InboundLedger) <<
+                "Starting deferred acquire of " << ledger->getHash ();
+
+            ledger->init (sl);
+            ++mCounter;
+        }
+    }
+
+    Json::Value getQueueJson ()
+    {
+        static char const* const names [kReasonCount] =
+            { "history", "generic", "publish", "validation", "current", "consensus" };
+
+        Json::Value ret (Json::objectValue);
+        ScopedLockType sl (mLock);
+
+        ActiveCounts const active (countActive ());
+        ActiveCounts waiting;
+        waiting.fill (0);
+
+        BOOST_FOREACH (Pending const& entry, mPending)
+            ++waiting[entry.reason];
+
+        for (int i = 0; i < kReasonCount; ++i)
+        {
+            if ((active[i] == 0) && (waiting[i] == 0))
+                continue;
+
+            Json::Value& entry (ret[names[i]] = Json::objectValue);
+            entry["active"] = active[i];
+            entry["pending"] = waiting[i];
+            if (getLimit (i) != 0)
+                entry["limit"] = getLimit (i);
+        }
+
+        ret["admitted"] = static_cast<Json::UInt> (mAdmitted);
+        ret["deferred"] = static_cast<Json::UInt> (mDeferred);
+        ret["shed"] = static_cast<Json::UInt> (mShed);
+
         return ret;
     }
 
@@ -135,7 +284,7 @@ public:
 
         ScopedLockType sl (mLock);
         mLedgers.erase (hash);
-
+        erasePending (hash);
     }
 
     /*
@@ -198,7 +347,8 @@ public:
             inboundLedgers.reserve(mLedgers.size());
             BOOST_FOREACH (const u256_acq_pair & it, mLedgers)
             {
-                inboundLedgers.push_back(it);
+                if (mPendingIndex.find (it.first) == mPendingIndex.end ())
+                    inboundLedgers.push_back(it);
             }
         }
 
@@ -270,6 +420,8 @@ public:
 
         mRecentFailures.clear();
         mLedgers.clear();
+        mPending.clear();
+        mPendingIndex.clear();
     }
 
     Json::Value getInfo()
@@ -326,39 +478,56 @@ public:
 
         clock_type::time_point const now (m_clock.now());
 
-        // Make a list of things to sweep, while holding the lock
+        // Make a list of things to sweep, while holding the lock. Each
+        // call visits part of the table, continuing from the last one.
+        // Visiting a ledger again after a rehash restarts the pass only
+        // repeats the checks below, which is harmless.
         std::vector <MapType::mapped_type> stuffToSweep;
         std::size_t total;
         {
             ScopedLockType sl (mLock);
-            MapType::iterator it (mLedgers.begin ());
             total = mLedgers.size ();
-            stuffToSweep.reserve (total);
 
-            while (it != mLedgers.end ())
+            std::size_t const buckets (mLedgers.bucket_count ());
+            std::size_t bucket;
+            std::size_t last;
+            mSweepCursor.next (buckets, SweepCursor::budget (buckets,
+                kSweepSliceBuckets, kSweepCallsPerPass), bucket, last);
+
+            for (; bucket < last; ++bucket)
             {
-                if (it->second->getLastAction () > now)
-                {
-                    it->second->touch ();
-                    ++it;
-                }
-                else if ((it->second->getLastAction () + std::chrono::minutes (1)) < now)
+                for (MapType::local_iterator it (mLedgers.begin (bucket));
+                    it != mLedgers.end (bucket); ++it)
                 {
-                    stuffToSweep.push_back (it->second);
-                    // shouldn't cause the actual final delete
-                    // since we are holding a reference in the vector.
-                    it = mLedgers.erase (it);
-                }
-                else
-                {
-                    ++it;
+                    if (mPendingIndex.find (it->first) != mPendingIndex.end ())
+                    {
+                        // Still waiting for a slot, so it cannot have stalled
+                        it->second->touch ();
+                    }
+                    else if (it->second->getLastAction () > now)
+                    {
+                        it->second->touch ();
+                    }
+                    else if ((it->second->getLastAction () + std::chrono::minutes (1)) < now)
+                    {
+                        // shouldn't cause the actual final delete
+                        // since we are holding a reference in the vector.
+                        stuffToSweep.push_back (it->second);
+                    }
                 }
             }
+
+            // Erasing through the container leaves the bucket
+            // iterators above untouched while we walk them.
+            BOOST_FOREACH (MapType::mapped_type const& ledger, stuffToSweep)
+                mLedgers.erase (ledger->getHash ());
         }
 
         WriteLog (lsDEBUG, InboundLedger) <<
             "Sweeped " << stuffToSweep.size () <<
             " out of " << total << " inbound ledgers.";
+
+        admitPending ();
     }
 
     void onStop ()
@@ -367,11 +536,95 @@ public:
 
         mLedgers.clear();
         mRecentFailures.clear();
+        mPending.clear();
+        mPendingIndex.clear();
 
         stopped();
     }
 
 private:
+    static const int kReasonCount = InboundLedger::fcCONSENSUS + 1;
+
+    typedef std::array <int, kReasonCount> ActiveCounts;
+
+    /** An acquisition waiting for a slot, most urgent first. */
+    struct Pending
+    {
+        Pending (InboundLedger::fcReason reason_, std::uint32_t seq_,
+                uint256 const& hash_)
+            : reason (reason_)
+            , seq (seq_)
+            , hash (hash_)
+        {
+        }
+
+        bool operator< (Pending const& other) const
+        {
+            if (reason != other.reason)
+                return reason > other.reason;
+            if (seq != other.seq)
+                return seq > other.seq;
+            return hash < other.hash;
+        }
+
+        InboundLedger::fcReason reason;
+        std::uint32_t seq;
+        uint256 hash;
+    };
+
+    typedef std::set <Pending> PendingSet;
+    typedef ripple::unordered_map <uint256, PendingSet::iterator> PendingIndex;
+
+    // The most acquisitions which may run at once for a reason, zero if unlimited.
+    // Publishing is not limited, LedgerMaster already asks for at most three
+    // ledgers each time it looks for ledgers to publish.
+    static int getLimit (int reason)
+    {
+        switch (reason)
+        {
+        case InboundLedger::fcHISTORY:  return 4;
+        case InboundLedger::fcGENERIC:  return 8;
+        default:
+            break;
+        };
+
+        return 0;
+    }
+
+    static bool canStart (int reason, ActiveCounts const& active)
+    {
+        int const limit (getLimit (reason));
+        return (limit == 0) || (active[reason] < limit);
+    }
+
+    // Count started acquisitions which have not finished, the lock must be held
+    ActiveCounts countActive () const
+    {
+        ActiveCounts active;
+        active.fill (0);
+
+        BOOST_FOREACH (MapType::value_type const& it, mLedgers)
+        {
+            if (!it.second->isDone () &&
+                (mPendingIndex.find (it.first) == mPendingIndex.end ()))
+                ++active[it.second->getReason ()];
+        }
+
+        return active;
+    }
+
+    // The lock must be held
+    void erasePending (uint256 const& hash)
+    {
+        PendingIndex::iterator const it (mPendingIndex.find (hash));
+
+        if (it != mPendingIndex.end ())
+        {
+            mPending.erase (it->second);
+            mPendingIndex.erase (it);
+        }
+    }
+
     clock_type& m_clock;
 
     typedef ripple::unordered_map <uint256, InboundLedger::pointer> MapType;
@@ -381,12 +634,19 @@ private:
     LockType mLock;
 
     MapType mLedgers;
+    SweepCursor mSweepCursor;
     KeyCache <uint256> mRecentFailures;
 
     uint256 mConsensusLedger;
     uint256 mValidationLedger;
 
     beast::insight::Counter mCounter;
+
+    PendingSet mPending;
+    PendingIndex mPendingIndex;
+    std::uint64_t mAdmitted;
+    std::uint64_t mDeferred;
+    std::uint64_t mShed;
 };
 
 //------------------------------------------------------------------------------
@@ -24,6 +24,13 @@ namespace ripple {
 
 /** Manages the lifetime of inbound ledgers.
 
+    The number of acquisitions running at once for each
+    InboundLedger::fcReason is limited. Requests over the limit are
+    remembered and started in order of priority, most important reason
+    first and then most recent ledger first, as running acquisitions
+    finish. Requesting a ledger which is already known, whether running
+    or waiting, returns the existing acquisition.
+
     @see InboundLedger
 */
 class InboundLedgers
@@ -42,6 +49,9 @@ public:
 
     // VFALCO TODO Should this be called findOrAdd ?
     //
+    // Returns null when stopping, or when the new request is shed because
+    // too many are waiting.
+    //
     virtual InboundLedger::pointer findCreate (uint256 const& hash, 
         std::uint32_t seq, InboundLedger::fcReason) = 0;
 
@@ -73,6 +83,12 @@ public:
 
     virtual Json::Value getInfo() = 0;
 
+    /** Returns the number of running and deferred acquisitions by reason. */
+    virtual Json::Value getQueueJson () = 0;
+
+    /** Start deferred acquisitions for which a slot has become free. */
+    virtual void admitPending () = 0;
+
     virtual void gotFetchPack (Job&) = 0;
     virtual void sweep () = 0;
 
@@ -438,12 +438,13 @@ SerializedTransaction::pointer Ledger::getSTransaction (SHAMapItem::ref item, SH
     SerializerIterator sit (item->peekSerializer ());
 
     if (type == SHAMapTreeNode::tnTRANSACTION_NM)
-        return boost::make_shared<SerializedTransaction> (boost::ref (sit));
+        return getApp().getMasterTransaction ().fetchParsed (
+            item->getTag (), item->peekSerializer ());
     else if (type == SHAMapTreeNode::tnTRANSACTION_MD)
     {
         Serializer sTxn (sit.getVL ());
-        SerializerIterator tSit (sTxn);
-        return boost::make_shared<SerializedTransaction> (boost::ref (tSit));
+        return getApp().getMasterTransaction ().fetchParsed (
+            item->getTag (), sTxn);
     }
 
     return SerializedTransaction::pointer ();
@@ -457,15 +458,16 @@ SerializedTransaction::pointer Ledger::getSMTransaction (SHAMapItem::ref item, S
     if (type == SHAMapTreeNode::tnTRANSACTION_NM)
     {
         txMeta.reset ();
-        return boost::make_shared<SerializedTransaction> (boost::ref (sit));
+        return getApp().getMasterTransaction ().fetchParsed (
+            item->getTag (), item->peekSerializer ());
     }
     else if (type == SHAMapTreeNode::tnTRANSACTION_MD)
     {
         Serializer sTxn (sit.getVL ());
-        SerializerIterator tSit (sTxn);
 
         txMeta = boost::make_shared<TransactionMetaSet> (item->getTag (), mLedgerSeq, sit.getVL ());
-        return boost::make_shared<SerializedTransaction> (boost::ref (tSit));
+        return getApp().getMasterTransaction ().fetchParsed (
+            item->getTag (), sTxn);
     }
 
     txMeta.reset ();
@@ -547,6 +549,45 @@ bool Ledger::getMetaHex (uint256 const& transID, std::string& hex)
     return true;
 }
 
+bool Ledger::getRawTransaction (uint256 const& transID, Blob& rawTxn, Blob& rawMeta)
+{
+    SHAMapTreeNode::TNType type;
+    SHAMapItem::pointer item = mTransactionMap->peekItem (transID, type);
+
+    if (!item)
+        return false;
+
+    if (type != SHAMapTreeNode::tnTRANSACTION_MD)
+        return false;
+
+    SerializerIterator it (item->peekSerializer ());
+    rawTxn = it.getVL ();
+    rawMeta = it.getVL ();
+    return true;
+}
+
+bool Ledger::loadTransactionBlobs (std::uint32_t ledgerSeq, uint256 const& transID,
+    Blob& rawTxn, Blob& rawMeta)
+{
+    Ledger::pointer ledger = getApp().getLedgerMaster ().getLedgerBySeq (ledgerSeq);
+
+    if (!ledger)
+    {
+        WriteLog (lsWARNING, Ledger) << "Ledger " << ledgerSeq << " is not available for txn " << transID;
+        return false;
+    }
+
+    try
+    {
+        return ledger->getRawTransaction (transID, rawTxn, rawMeta);
+    }
+    catch (SHAMapMissingNode&)
+    {
+        WriteLog (lsWARNING, Ledger) << "Ledger " << ledgerSeq << " is missing nodes for txn " << transID;
+        return false;
+    }
+}
+
 uint256 Ledger::getHash ()
 {
     if (!mValidHash)
@@ -662,8 +703,13 @@ bool Ledger::saveValidatedLedger (bool current)
             else
                 WriteLog (lsWARNING, Ledger) << "Transaction in ledger " << mLedgerSeq << " affects no accounts";
 
-            db->executeSQL (SerializedTransaction::getMetaSQLInsertReplaceHeader () +
-                            vt.second->getTxn ()->getMetaSQL (getLedgerSeq (), vt.second->getEscMeta ()) + ";");
+            if (getConfig ().TXN_DB_BLOBS)
+                db->executeSQL (SerializedTransaction::getMetaSQLInsertReplaceHeader () +
+                                vt.second->getTxn ()->getMetaSQL (getLedgerSeq (), vt.second->getEscMeta ()) + ";");
+            else // The blobs are read back from our transaction tree
+                db->executeSQL (SerializedTransaction::getMetaSQLInsertReplaceHeader () +
+                                vt.second->getTxn ()->getMetaSQL (Serializer (), getLedgerSeq (),
+                                    TXN_SQL_VALIDATED, "NULL") + ";");
         }
         db->executeSQL ("COMMIT TRANSACTION;");
     }
@@ -1200,6 +1246,14 @@ SLE::pointer Ledger::getSLE (uint256 const& uHash)
 
 SLE::pointer Ledger::getSLEi (uint256 const& uId)
 {
+    if (mImmutable)
+    {
+        SLE::pointer ret = mEntryCache.fetch (uId);
+
+        if (ret)
+            return ret;
+    }
+
     uint256 hash;
 
     SHAMapItem::pointer node = mAccountStateMap->peekItem (uId, hash);
@@ -1216,6 +1270,9 @@ SLE::pointer Ledger::getSLEi (uint256 const& uId)
         getApp().getSLECache ().canonicalize (hash, ret);
     }
 
+    if (mImmutable)
+        mEntryCache.insert (uId, ret);
+
     return ret;
 }
 
@@ -2065,4 +2122,6 @@ BEAST_DEFINE_TESTSUITE(Ledger,ripple_app,ripple);
 Ledger::StaticLockType Ledger::sPendingSaveLock;
 std::set<std::uint32_t> Ledger::sPendingSaves;
 
+LedgerEntryCache::Counters LedgerEntryCache::s_counters [LedgerEntryCache::counterStripes];
+
 } // ripple
@@ -255,6 +255,15 @@ public:
     bool getTransaction (uint256 const & transID, Transaction::pointer & txn, TransactionMetaSet::pointer & txMeta);
     bool getTransactionMeta (uint256 const & transID, TransactionMetaSet::pointer & txMeta);
     bool getMetaHex (uint256 const & transID, std::string & hex);
+    bool getRawTransaction (uint256 const & transID, Blob & rawTxn, Blob & rawMeta);
+
+    /** Retrieve the blobs for a transaction database row which doesn't hold them.
+        When the transaction database is configured not to store transaction
+        and metadata blobs, they are read from the transaction tree of the
+        ledger which contains the transaction instead.
+    */
+    static bool loadTransactionBlobs (std::uint32_t ledgerSeq, uint256 const & transID,
+        Blob & rawTxn, Blob & rawMeta);
 
     static SerializedTransaction::pointer getSTransaction (SHAMapItem::ref, SHAMapTreeNode::TNType);
     SerializedTransaction::pointer getSMTransaction (SHAMapItem::ref, SHAMapTreeNode::TNType,
@@ -508,6 +517,9 @@ private:
     SHAMap::pointer mTransactionMap;
     SHAMap::pointer mAccountStateMap;
 
+    // Entries read from the state map once the ledger is immutable
+    LedgerEntryCache mEntryCache;
+
     typedef RippleMutex StaticLockType;
     typedef std::lock_guard <StaticLockType> StaticScopedLockType;
     // ledgers not fully saved, validated ledger present but DB may not be correct yet
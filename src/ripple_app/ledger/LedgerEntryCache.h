@@ -0,0 +1,157 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_LEDGERENTRYCACHE_H
+#define RIPPLE_LEDGERENTRYCACHE_H
+
+namespace ripple {
+
+/** Maps ledger entry indexes directly to entries for one immutable ledger.
+
+    This lets repeated lookups of the same account roots, trust lines and
+    directories skip the walk down the state tree. The table is direct
+    mapped: each slot holds a shared pointer to an index and entry pair,
+    which is loaded and replaced atomically, and an insertion into an
+    occupied slot simply replaces it. No lock is taken.
+
+    The slots are allocated on the first insertion, so ledgers which are
+    never read from cost a single pointer. The cache goes away with the
+    ledger that owns it.
+*/
+class LedgerEntryCache : public beast::Uncopyable
+{
+public:
+    enum
+    {
+        slotCount = 4096
+
+        // Must be a power of two
+        ,counterStripes = 16
+    };
+
+    LedgerEntryCache ()
+        : m_slots (nullptr)
+    {
+    }
+
+    ~LedgerEntryCache ()
+    {
+        delete [] m_slots.load ();
+    }
+
+    SLE::pointer fetch (uint256 const& index) const
+    {
+        Slot const* const slots (m_slots.load (std::memory_order_acquire));
+
+        if (slots != nullptr)
+        {
+            boost::shared_ptr <Entry const> const entry (
+                boost::atomic_load (&slots [slotFor (index)]));
+
+            if (entry && (entry->index == index))
+            {
+                counters ().hits.fetch_add (1, std::memory_order_relaxed);
+                return entry->sle;
+            }
+        }
+
+        counters ().misses.fetch_add (1, std::memory_order_relaxed);
+        return SLE::pointer ();
+    }
+
+    void insert (uint256 const& index, SLE::ref sle)
+    {
+        Slot* slots (m_slots.load (std::memory_order_acquire));
+
+        if (slots == nullptr)
+        {
+            Slot* const fresh (new Slot [slotCount]);
+
+            if (m_slots.compare_exchange_strong (slots, fresh))
+                slots = fresh;
+            else
+                delete [] fresh;
+        }
+
+        boost::atomic_store (&slots [slotFor (index)],
+            boost::make_shared <Entry const> (index, sle));
+    }
+
+    /** Returns the percentage of lookups, across all ledgers, that hit. */
+    static float getHitRate ()
+    {
+        std::uint64_t hits (0);
+        std::uint64_t misses (0);
+
+        for (int i = 0; i < counterStripes; ++i)
+        {
+            hits += s_counters [i].hits.load (std::memory_order_relaxed);
+            misses += s_counters [i].misses.load (std::memory_order_relaxed);
+        }
+
+        return (static_cast<float> (hits) * 100) / (1.0f + hits + misses);
+    }
+
+private:
+    struct Entry
+    {
+        Entry (uint256 const& index_, SLE::ref sle_)
+            : index (index_)
+            , sle (sle_)
+        {
+        }
+
+        uint256 const index;
+        SLE::pointer const sle;
+    };
+
+    typedef boost::shared_ptr <Entry const> Slot;
+
+    // Indexes are hashes, so their leading bytes are already well mixed
+    static std::size_t slotFor (uint256 const& index)
+    {
+        return ((index.begin ()[0] << 8) | index.begin ()[1]) % slotCount;
+    }
+
+    // Every lookup is counted. So that readers don't all write the same
+    // cache line, each thread counts in one of several padded stripes.
+    struct Counters
+    {
+        std::atomic <std::uint64_t> hits;
+        std::atomic <std::uint64_t> misses;
+        char pad [64 - 2 * sizeof (std::atomic <std::uint64_t>)];
+    };
+
+    static Counters& counters ()
+    {
+        // Thread ids are often aligned addresses, so mix in the high bits
+        std::uint64_t const id (std::hash <std::thread::id> () (
+            std::this_thread::get_id ()));
+        return s_counters [((id * 0x9E3779B97F4A7C15ULL) >> 32) &
+            (counterStripes - 1)];
+    }
+
+    std::atomic <Slot*> m_slots;
+
+    static Counters s_counters [counterStripes];
+};
+
+} // ripple
+
+#endif
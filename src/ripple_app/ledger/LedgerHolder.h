@@ -22,16 +22,15 @@
 
 namespace ripple {
 
-// Can std::atomic<std::shared_ptr>> make this lock free?
-
 /** Hold a ledger in a thread-safe way.
+
+    The pointer is published and read with the atomic shared pointer
+    operations, so readers never wait on each other or on a writer for
+    longer than it takes to copy the pointer.
 */
 class LedgerHolder
 {
 public:
-    typedef RippleMutex LockType;
-    typedef std::lock_guard <LockType> ScopedLockType;
-
     // Update the held ledger
     void set (Ledger::pointer ledger)
     {
@@ -39,39 +38,29 @@ public:
         if (ledger && !ledger->isImmutable ())
            ledger = boost::make_shared <Ledger> (*ledger, false);
 
-        {
-            ScopedLockType sl (m_lock);
-
-            m_heldLedger = ledger;
-        }
+        boost::atomic_store (&m_heldLedger, ledger);
     }
 
     // Return the (immutable) held ledger
-    Ledger::pointer get ()
+    Ledger::pointer get () const
     {
-        ScopedLockType sl (m_lock);
-
-        return m_heldLedger;
+        return boost::atomic_load (&m_heldLedger);
     }
 
     // Return a mutable snapshot of the held ledger
-    Ledger::pointer getMutable ()
+    Ledger::pointer getMutable () const
     {
         Ledger::pointer ret = get ();
         return ret ? boost::make_shared <Ledger> (*ret, true) : ret;
     }
 
 
-    bool empty ()
+    bool empty () const
     {
-        ScopedLockType sl (m_lock);
-
-        return m_heldLedger == nullptr;
+        return get () == nullptr;
     }
 
 private:
-
-    LockType m_lock;
     Ledger::pointer m_heldLedger;
 
 };
@@ -49,7 +49,7 @@ public:
     LedgerHolder mCurrentLedger;        // The ledger we are currently processiong
     LedgerHolder mClosedLedger;         // The ledger that most recently closed
     LedgerHolder mValidLedger;          // The highest-sequence ledger we have fully accepted
-    Ledger::pointer mPubLedger;         // The last ledger we have published
+    LedgerHolder mPubLedger;            // The last ledger we have published
     Ledger::pointer mPathLedger;        // The last ledger we did pathfinding against
 
     LedgerHistory mLedgerHistory;
@@ -182,7 +182,7 @@ public:
 
     void setPubLedger(Ledger::ref l)
     {
-        mPubLedger = l;
+        mPubLedger.set (l);
         mPubLedgerClose = l->getCloseTimeNC();
         mPubLedgerSeq = l->getLedgerSeq();
     }
@@ -619,7 +619,7 @@ public:
 
             if (ledger->getLedgerSeq() > mValidLedgerSeq)
                 setValidLedger(ledger);
-            if (!mPubLedger)
+            if (mPubLedger.empty ())
             {
                 setPubLedger(ledger);
                 getApp().getOrderBookDB().setup(ledger);
@@ -743,7 +743,7 @@ public:
         ledger->setValidated();
         ledger->setFull();
         setValidLedger(ledger);
-        if (!mPubLedger)
+        if (mPubLedger.empty ())
         {
             ledger->pendSaveValidated(true, true);
             setPubLedger(ledger);
@@ -891,7 +891,7 @@ public:
                     std::uint32_t missing;
                     {
                         ScopedLockType sl (mCompleteLock);
-                        missing = mCompleteLedgers.prevMissing(mPubLedger->getLedgerSeq());
+                        missing = mCompleteLedgers.prevMissing(mPubLedgerSeq);
                     }
                     WriteLog (lsTRACE, LedgerMaster) << "tryAdvance discovered missing " << missing;
                     if ((missing != RangeSet::absent) && (missing > 0) &&
@@ -914,7 +914,7 @@ public:
                                             getApp().getInboundLedgers().findCreate(nextLedger->getParentHash(),
                                                                                     nextLedger->getLedgerSeq() - 1,
                                                                                     InboundLedger::fcHISTORY);
-                                        if (acq->isComplete() && !acq->isFailed())
+                                        if (acq && acq->isComplete() && !acq->isFailed())
                                             ledger = acq->getLedger();
                                         else if ((missing > 40000) && getApp().getOPs().shouldFetchPack(missing))
                                         {
@@ -1009,7 +1009,7 @@ public:
         std::list<Ledger::pointer> ret;
 
         WriteLog (lsTRACE, LedgerMaster) << "findNewLedgersToPublish<";
-        if (!mPubLedger)
+        if (mPubLedger.empty ())
         {
             WriteLog (lsINFO, LedgerMaster) << "First published ledger will be " << mValidLedgerSeq;
             ret.push_back (mValidLedger.get ());
@@ -1059,9 +1059,9 @@ public:
                     if (!ledger && (++acqCount < 4))
                     { // We can try to acquire the ledger we need
                         InboundLedger::pointer acq =
-                            getApp().getInboundLedgers ().findCreate (hash, seq, InboundLedger::fcGENERIC);
+                            getApp().getInboundLedgers ().findCreate (hash, seq, InboundLedger::fcPUBLISH);
 
-                        if (!acq->isDone ())
+                        if (!acq || !acq->isDone ())
                         {
                             nothing ();
                         }
@@ -1073,8 +1073,8 @@ public:
                         {
                             WriteLog (lsWARNING, LedgerMaster) << "Failed to acquire a published ledger";
                             getApp().getInboundLedgers().dropLedger(hash);
-                            acq = getApp().getInboundLedgers().findCreate(hash, seq, InboundLedger::fcGENERIC);
-                            if (acq->isComplete())
+                            acq = getApp().getInboundLedgers().findCreate(hash, seq, InboundLedger::fcPUBLISH);
+                            if (acq && acq->isComplete())
                             {
                                 if (acq->isFailed())
                                     getApp().getInboundLedgers().dropLedger(hash);
@@ -1269,9 +1269,9 @@ public:
     }
 
     // This is the last ledger we published to clients and can lag the validated ledger
-    Ledger::ref getPublishedLedger ()
+    Ledger::pointer getPublishedLedger ()
     {
-        return mPubLedger;
+        return mPubLedger.get ();
     }
 
     int getMinValidations ()
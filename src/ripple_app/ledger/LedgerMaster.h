@@ -62,7 +62,7 @@ public:
     virtual Ledger::pointer getValidatedLedger () = 0;
 
     // This is the last ledger we published to clients and can lag the validated ledger
-    virtual Ledger::ref getPublishedLedger () = 0;
+    virtual Ledger::pointer getPublishedLedger () = 0;
 
     virtual int getPublishedLedgerAge () = 0;
     virtual int getValidatedLedgerAge () = 0;
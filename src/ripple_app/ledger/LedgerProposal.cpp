@@ -23,7 +23,7 @@ LedgerProposal::LedgerProposal (uint256 const& pLgr, std::uint32_t seq,
                                 uint256 const& tx, std::uint32_t closeTime,
                                 const RippleAddress& naPeerPublic, uint256 const& suppression) :
     mPreviousLedger (pLgr), mCurrentHash (tx), mSuppression (suppression), mCloseTime (closeTime),
-    mProposeSeq (seq), mPublicKey (naPeerPublic)
+    mProposeSeq (seq), mPublicKey (naPeerPublic), mHasDelta (false)
 {
     // XXX Validate key.
     // if (!mKey->SetPubKey(pubKey))
@@ -38,7 +38,7 @@ LedgerProposal::LedgerProposal (const RippleAddress& naPub, const RippleAddress&
                                 uint256 const& prevLgr, uint256 const& position,
                                 std::uint32_t closeTime) :
     mPreviousLedger (prevLgr), mCurrentHash (position), mCloseTime (closeTime), mProposeSeq (0),
-    mPublicKey (naPub), mPrivateKey (naPriv)
+    mPublicKey (naPub), mPrivateKey (naPriv), mHasDelta (false)
 {
     mPeerID      = mPublicKey.getNodeID ();
     mTime        = boost::posix_time::second_clock::universal_time ();
@@ -46,7 +46,8 @@ LedgerProposal::LedgerProposal (const RippleAddress& naPub, const RippleAddress&
 
 LedgerProposal::LedgerProposal (uint256 const& prevLgr, uint256 const& position,
                                 std::uint32_t closeTime) :
-    mPreviousLedger (prevLgr), mCurrentHash (position), mCloseTime (closeTime), mProposeSeq (0)
+    mPreviousLedger (prevLgr), mCurrentHash (position), mCloseTime (closeTime), mProposeSeq (0),
+    mHasDelta (false)
 {
     mTime       = boost::posix_time::second_clock::universal_time ();
 }
@@ -30,6 +30,9 @@ public:
 
     static const std::uint32_t seqLeave = 0xffffffff; // leaving the consensus process
 
+    // The most transaction changes a proposal may list against an earlier set
+    static const int maxSetDelta = 256;
+
     typedef boost::shared_ptr<LedgerProposal> pointer;
     typedef const pointer& ref;
 
@@ -119,6 +122,36 @@ public:
         return mTime <= cutoff;
     }
 
+    /** Record how a peer's set differs from an earlier set.
+        These hints are not signed. They only help us rebuild the
+        proposed set, which is still checked against its signed hash.
+        @param base The earlier set, or zero for the empty set.
+    */
+    void setDelta (uint256 const& base, std::vector<uint256>& added,
+                   std::vector<uint256>& removed)
+    {
+        mHasDelta = true;
+        mDeltaBase = base;
+        mAdded.swap (added);
+        mRemoved.swap (removed);
+    }
+    bool hasDelta () const
+    {
+        return mHasDelta;
+    }
+    uint256 const& getDeltaBase () const
+    {
+        return mDeltaBase;
+    }
+    std::vector<uint256> const& getAdded () const
+    {
+        return mAdded;
+    }
+    std::vector<uint256> const& getRemoved () const
+    {
+        return mRemoved;
+    }
+
     bool changePosition (uint256 const & newPosition, std::uint32_t newCloseTime);
     void bowOut ();
     Json::Value getJson () const;
@@ -141,6 +174,12 @@ private:
 
     std::string                 mSignature; // set only if needed
     boost::posix_time::ptime    mTime;
+
+    // Transactions changed relative to an earlier set, if the peer sent them
+    bool                        mHasDelta;
+    uint256                     mDeltaBase;
+    std::vector<uint256>        mAdded;
+    std::vector<uint256>        mRemoved;
 };
 
 } // ripple
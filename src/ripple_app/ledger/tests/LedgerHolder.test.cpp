@@ -0,0 +1,149 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "../../../beast/beast/unit_test/suite.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace ripple {
+
+/** Measures how readers of LedgerHolder scale with contention.
+
+    LedgerHolder publishes ledgers with the atomic shared pointer operations.
+    This compares it to guarding the pointer with a mutex, which is what it
+    did before, with several threads reading the held ledger while another
+    keeps closing new ledgers and setting them.
+*/
+class LedgerHolder_test : public beast::unit_test::suite
+{
+public:
+    class LockedHolder
+    {
+    public:
+        void set (Ledger::pointer const& ledger)
+        {
+            std::lock_guard <std::mutex> lock (m_mutex);
+            m_held = ledger;
+        }
+
+        Ledger::pointer get ()
+        {
+            std::lock_guard <std::mutex> lock (m_mutex);
+            return m_held;
+        }
+
+    private:
+        std::mutex m_mutex;
+        Ledger::pointer m_held;
+    };
+
+    // Returns the number of reads per second, across all readers
+    template <class Holder>
+    double measure (Ledger::ref genesis, int readerCount)
+    {
+        int const readsPerThread = 1000000;
+
+        Holder holder;
+        holder.set (genesis);
+
+        std::atomic <bool> done (false);
+        std::atomic <int> failures (0);
+
+        std::thread writer ([&]
+        {
+            Ledger::pointer ledger (genesis);
+
+            while (! done)
+            {
+                // The ledger after this one, closed as LedgerMaster sets it
+                ledger = boost::make_shared <Ledger> (false, *ledger);
+                ledger->setClosed ();
+                ledger->setImmutable ();
+
+                holder.set (ledger);
+                std::this_thread::sleep_for (std::chrono::microseconds (100));
+            }
+        });
+
+        std::chrono::steady_clock::time_point const start (
+            std::chrono::steady_clock::now ());
+
+        std::vector <std::thread> readers;
+
+        for (int i = 0; i < readerCount; ++i)
+        {
+            readers.emplace_back ([&]
+            {
+                for (int j = 0; j < readsPerThread; ++j)
+                {
+                    Ledger::pointer const ledger (holder.get ());
+
+                    if (! ledger || ! ledger->isImmutable ())
+                        ++failures;
+                }
+            });
+        }
+
+        for (auto& reader : readers)
+            reader.join ();
+
+        double const seconds (std::chrono::duration_cast <
+            std::chrono::duration <double>> (
+                std::chrono::steady_clock::now () - start).count ());
+
+        done = true;
+        writer.join ();
+
+        expect (failures == 0, "Reader saw no immutable ledger");
+
+        return (double (readsPerThread) * readerCount) / seconds;
+    }
+
+    void run ()
+    {
+        RippleAddress const seed (RippleAddress::createSeedGeneric ("masterpassphrase"));
+        RippleAddress const master (RippleAddress::createAccountPublic (
+            RippleAddress::createGeneratorPublic (seed), 0));
+
+        Ledger::pointer const genesis (boost::make_shared <Ledger> (master, SYSTEM_CURRENCY_START));
+        genesis->setClosed ();
+        genesis->setImmutable ();
+
+        int const maxReaders (std::max (2u, std::thread::hardware_concurrency ()));
+
+        for (int readers = 1; readers <= maxReaders; readers *= 2)
+        {
+            double const locked (measure <LockedHolder> (genesis, readers));
+            double const atomic (measure <LedgerHolder> (genesis, readers));
+
+            log <<
+                readers << " readers: " <<
+                std::int64_t (locked) << " reads/s with a mutex, " <<
+                std::int64_t (atomic) << " reads/s with LedgerHolder";
+        }
+
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(LedgerHolder,ripple_app,ripple);
+
+} // ripple
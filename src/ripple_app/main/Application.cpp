@@ -235,7 +235,7 @@ public:
             "full_below", get_seconds_clock (), m_collectorManager->collector (),
                 fullBelowTargetSize, fullBelowExpirationSeconds))
 
-        , m_nodeStoreScheduler (*this)
+        , m_nodeStoreScheduler (*this, m_collectorManager->collector ())
 
         // The JobQueue has to come pretty early since
         // almost everything is a Stoppable child of the JobQueue.
@@ -663,6 +663,7 @@ public:
         m_sleCache.setTargetSize (getConfig ().getSize (siSLECacheSize));
         m_sleCache.setTargetAge (getConfig ().getSize (siSLECacheAge));
         SHAMap::setTreeCache (getConfig ().getSize (siTreeCacheSize), getConfig ().getSize (siTreeCacheAge));
+        SHAMap::setProofCache (getConfig ().getSize (siProofCacheSize), getConfig ().getSize (siProofCacheAge));
 
 
         //----------------------------------------------------------------------
@@ -1008,7 +1009,12 @@ public:
         //         have listeners register for "onSweep ()" notification.
         //
 
-        m_fullBelowCache->sweep ();
+        // The caches below sweep in slices of their hash tables and
+        // release their locks in between, so lookups are not stalled
+        // for the duration of the whole sweep.
+        //
+        logTimedCall (m_journal.warning, "FullBelowCache::sweep", __FILE__, __LINE__, boost::bind (
+            &FullBelowCache::sweep, m_fullBelowCache.get ()));
 
         logTimedCall (m_journal.warning, "TransactionMaster::sweep", __FILE__, __LINE__, boost::bind (
             &TransactionMaster::sweep, &m_txMaster));
@@ -1330,6 +1336,165 @@ static void addTxnSeqField ()
     db->executeSQL ("END TRANSACTION;");
 }
 
+// When the transaction tree of each ledger is the only copy we keep,
+// drop the copies of validated transactions saved by older versions.
+//
+// This runs once, in the background, a batch of ledgers per job. A row in
+// the Migrations table holds the last ledger done and the last ledger to
+// do, so that a restart resumes where it stopped. Only the rows of ledgers
+// whose transaction tree is complete in the node store are stripped, the
+// rest keep their blobs. The freed space is only reclaimed with --vacuum.
+
+static char const* const removeTxnBlobsName = "RemoveTxnBlobs";
+
+// Records the range of ledgers to strip, the first time.
+// Returns true if some of them remain to be done.
+static bool prepareRemoveTxnBlobs ()
+{
+    if (getConfig ().TXN_DB_BLOBS)
+        return false;
+
+    DatabaseCon* const txnDB = getApp().getTxnDB ();
+    Database* db = txnDB->getDB ();
+    DeprecatedScopedLock sl (txnDB->getDBLock ());
+
+    db->executeSQL ("CREATE TABLE IF NOT EXISTS Migrations "
+        "(Name TEXT PRIMARY KEY, Progress INTEGER, Target INTEGER);");
+
+    if (db->executeSQL (boost::str (boost::format (
+            "SELECT Progress, Target FROM Migrations WHERE Name = '%s';")
+                % removeTxnBlobsName)) && db->startIterRows ())
+    {
+        bool const remaining (db->getBigInt ("Progress") < db->getBigInt ("Target"));
+        db->endIterRows ();
+        return remaining;
+    }
+
+    // Ledgers saved from now on have no blobs, so the range is fixed
+    std::uint32_t first (0);
+    std::uint32_t last (0);
+
+    if (db->executeSQL ("SELECT MIN(LedgerSeq) AS First, MAX(LedgerSeq) AS Last "
+            "FROM Transactions;") && db->startIterRows ())
+    {
+        if (!db->getNull ("First"))
+        {
+            first = db->getInt ("First");
+            last = db->getInt ("Last");
+        }
+
+        db->endIterRows ();
+    }
+
+    std::uint32_t const progress ((first == 0) ? 0 : (first - 1));
+
+    db->executeSQL (boost::str (boost::format (
+        "INSERT INTO Migrations (Name, Progress, Target) VALUES ('%s', %u, %u);")
+            % removeTxnBlobsName % progress % last));
+
+    if (progress < last)
+        Log (lsINFO) << "Transaction blobs of ledgers " << first << " to " << last <<
+            " will be removed in the background";
+
+    return progress < last;
+}
+
+// Strips the next batch of ledgers, then queues the following one
+static void removeTxnBlobs (Job& job)
+{
+    static std::uint32_t const ledgersPerBatch = 256;
+
+    DatabaseCon* const txnDB = getApp().getTxnDB ();
+    Database* db = txnDB->getDB ();
+
+    std::uint32_t progress (0);
+    std::uint32_t target (0);
+    std::vector <std::uint32_t> ledgers;
+
+    {
+        DeprecatedScopedLock sl (txnDB->getDBLock ());
+
+        if (!db->executeSQL (boost::str (boost::format (
+                "SELECT Progress, Target FROM Migrations WHERE Name = '%s';")
+                    % removeTxnBlobsName)) || !db->startIterRows ())
+            return;
+
+        progress = static_cast <std::uint32_t> (db->getBigInt ("Progress"));
+        target = static_cast <std::uint32_t> (db->getBigInt ("Target"));
+        db->endIterRows ();
+
+        if (progress >= target)
+            return;
+
+        SQL_FOREACH (db, boost::str (boost::format (
+            "SELECT DISTINCT LedgerSeq FROM Transactions "
+            "WHERE LedgerSeq > %u AND LedgerSeq <= %u "
+            "AND Status = '%c' AND length(RawTxn) > 0;")
+                % progress % std::min (target, progress + ledgersPerBatch)
+                % TXN_SQL_VALIDATED))
+        {
+            ledgers.push_back (db->getInt ("LedgerSeq"));
+        }
+    }
+
+    std::uint32_t const last (std::min (target, progress + ledgersPerBatch));
+
+    // Check the ledgers without holding the database lock
+    std::vector <std::uint32_t> complete;
+
+    BOOST_FOREACH (std::uint32_t seq, ledgers)
+    {
+        if (job.shouldCancel ())
+            return;
+
+        Ledger::pointer ledger (Ledger::loadByIndex (seq));
+        std::vector <SHAMapMissingNode> missing;
+
+        if (ledger)
+            ledger->peekTransactionMap ()->walkMap (missing, 1);
+
+        if (ledger && missing.empty ())
+            complete.push_back (seq);
+    }
+
+    {
+        DeprecatedScopedLock sl (txnDB->getDBLock ());
+
+        db->executeSQL ("BEGIN TRANSACTION;");
+
+        BOOST_FOREACH (std::uint32_t seq, complete)
+        {
+            db->executeSQL (boost::str (boost::format (
+                "UPDATE Transactions SET RawTxn = NULL, TxnMeta = NULL "
+                "WHERE LedgerSeq = %u AND Status = '%c';") % seq % TXN_SQL_VALIDATED));
+        }
+
+        db->executeSQL (boost::str (boost::format (
+            "UPDATE Migrations SET Progress = %u WHERE Name = '%s';")
+                % last % removeTxnBlobsName));
+
+        db->executeSQL ("END TRANSACTION;");
+    }
+
+    if (complete.size () != ledgers.size ())
+        Log (lsWARNING) << "Kept the transaction blobs of " <<
+            (ledgers.size () - complete.size ()) << " ledgers up to " << last <<
+            " which are not complete in the node store";
+
+    if (last < target)
+    {
+        Log (lsDEBUG) << "Transaction blobs removed up to ledger " << last << " of " << target;
+
+        getApp().getJobQueue ().addJob (jtADMIN, "removeTxnBlobs",
+            BIND_TYPE (&removeTxnBlobs, P_1));
+    }
+    else
+    {
+        Log (lsINFO) << "Transaction blobs removed up to ledger " << target <<
+            ", start once with --vacuum to reclaim the space";
+    }
+}
+
 void ApplicationImp::updateTables ()
 {
     if (getConfig ().nodeDatabase.size () <= 0)
@@ -1344,6 +1509,16 @@ void ApplicationImp::updateTables ()
     assert (!schemaHas (getApp().getTxnDB (), "AccountTransactions", 0, "foobar"));
     addTxnSeqField ();
 
+    if (prepareRemoveTxnBlobs ())
+        m_jobQueue->addJob (jtADMIN, "removeTxnBlobs", BIND_TYPE (&removeTxnBlobs, P_1));
+
+    if (getConfig ().doVacuum)
+    {
+        Log (lsWARNING) << "Compacting the transaction database, this may take a long time";
+        DeprecatedScopedLock sl (getApp().getTxnDB ()->getDBLock ());
+        getApp().getTxnDB ()->getDB ()->executeSQL ("VACUUM;");
+    }
+
     if (schemaHas (getApp().getTxnDB (), "AccountTransactions", 0, "PRIMARY"))
     {
         Log (lsFATAL) << "AccountTransactions database should not have a primary key";
@@ -102,6 +102,7 @@ void printHelp (const po::options_description& desc)
     cerr << "     ripple_path_find <json> [<ledger>]" << endl;
     //  cerr << "     send <seed> <paying_account> <account_id> <amount> [<currency>] [<send_max>] [<send_currency>]" << endl;
     cerr << "     stop" << endl;
+    cerr << "     submit_benchmark [<transactions> [<accounts>]]" << endl;
     cerr << "     tx <id>" << endl;
     cerr << "     unl_add <domain>|<public> [<comment>]" << endl;
     cerr << "     unl_delete <domain>|<public_key>" << endl;
@@ -208,6 +209,7 @@ int run (int argc, char** argv)
     ("net", "Get the initial ledger from the network.")
     ("fg", "Run in the foreground.")
     ("import", importDescription.toStdString ().c_str ())
+    ("vacuum", "Compact the transaction database at startup.")
     ("version", "Display the build version.")
     ;
 
@@ -322,6 +324,11 @@ int run (int argc, char** argv)
         getConfig ().doImport = true;
     }
 
+    if (vm.count ("vacuum"))
+    {
+        getConfig ().doVacuum = true;
+    }
+
     if (vm.count ("ledger"))
     {
         getConfig ().START_LEDGER = vm["ledger"].as<std::string> ();
@@ -19,10 +19,14 @@
 
 namespace ripple {
 
-NodeStoreScheduler::NodeStoreScheduler (Stoppable& parent)
+NodeStoreScheduler::NodeStoreScheduler (Stoppable& parent,
+    beast::insight::Collector::ptr const& collector)
     : Stoppable ("NodeStoreScheduler", parent)
     , m_jobQueue (nullptr)
     , m_taskCount (0)
+    , m_writeTime (collector->make_event ("nodestore.batch_write"))
+    , m_writeSize (collector->make_gauge ("nodestore.batch_size"))
+    , m_writePending (collector->make_gauge ("nodestore.write_pending"))
 {
 }
 
@@ -51,6 +55,13 @@ void NodeStoreScheduler::scheduleTask (NodeStore::Task& task)
             this, boost::ref(task), P_1));
 }
 
+void NodeStoreScheduler::onBatchWrite (NodeStore::BatchWriteReport const& report)
+{
+    m_writeTime.notify (report.elapsed);
+    m_writeSize.set (report.writeCount);
+    m_writePending.set (report.pendingCount);
+}
+
 void NodeStoreScheduler::doTask (NodeStore::Task& task, Job&)
 {
     task.performScheduledTask ();
@@ -28,7 +28,8 @@ class NodeStoreScheduler
     , public beast::Stoppable
 {
 public:
-    NodeStoreScheduler (Stoppable& parent);
+    NodeStoreScheduler (Stoppable& parent,
+        beast::insight::Collector::ptr const& collector);
 
     // VFALCO NOTE This is a temporary hack to solve the problem
     //             of circular dependency.
@@ -38,12 +39,17 @@ public:
     void onStop ();
     void onChildrenStopped ();
     void scheduleTask (NodeStore::Task& task);
+    void onBatchWrite (NodeStore::BatchWriteReport const& report);
 
 private:
     void doTask (NodeStore::Task& task, Job&);
 
     JobQueue* m_jobQueue;
     std::atomic <int> m_taskCount;
+
+    beast::insight::Event m_writeTime;
+    beast::insight::Gauge m_writeSize;
+    beast::insight::Gauge m_writePending;
 };
 
 } // ripple
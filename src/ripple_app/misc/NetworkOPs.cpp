@@ -234,7 +234,7 @@ public:
     void processTrustedProposal (LedgerProposal::pointer proposal, boost::shared_ptr<protocol::TMProposeSet> set,
                                  RippleAddress nodePublic, uint256 checkLedger, bool sigGood);
     SHAMapAddNode gotTXData (const boost::shared_ptr<Peer>& peer, uint256 const& hash,
-                             const std::list<SHAMapNode>& nodeIDs, const std::list< Blob >& nodeData);
+                             const std::vector<SHAMapNode>& nodeIDs, const std::list< Blob >& nodeData);
     bool recvValidation (SerializedValidation::ref val, const std::string& source);
     void takePosition (int seq, SHAMap::ref position);
     SHAMap::pointer getTXMap (uint256 const& hash);
@@ -348,6 +348,21 @@ public:
         return m_localTX->size ();
     }
 
+    // The columns of a transaction row. The rows are read while holding the
+    // database lock and the blobs kept only in the ledger are loaded after.
+    struct AccountTxRow
+    {
+        uint256         transID;
+        std::uint32_t   ledgerSeq;
+        std::string     status;
+        Blob            rawTxn;
+        Blob            rawMeta;
+    };
+
+    static AccountTxRow readAccountTxRow (Database* db);
+    bool loadAccountTxBlobs (AccountTxRow& row);
+    Transaction::pointer loadAccountTx (AccountTxRow& row);
+
     //Helper function to generate SQL query to get transactions
     std::string transactionsSQL (std::string selection, const RippleAddress& account,
                                  std::int32_t minLedger, std::int32_t maxLedger,
@@ -755,10 +770,10 @@ void NetworkOPsImp::submitTransaction (Job&, SerializedTransaction::pointer iTra
     Serializer s;
     iTrans->add (s);
 
-    SerializerIterator sit (s);
-    SerializedTransaction::pointer trans = boost::make_shared<SerializedTransaction> (boost::ref (sit));
+    uint256 suppress = s.getPrefixHash (HashPrefix::transactionID);
+    SerializedTransaction::pointer trans =
+        getApp().getMasterTransaction ().fetchParsed (suppress, s);
 
-    uint256 suppress = trans->getTransactionID ();
     int flags;
 
     if (getApp().getHashRouter ().addSuppressionPeer (suppress, 0, flags) && ((flags & SF_RETRY) != 0))
@@ -1611,7 +1626,7 @@ void NetworkOPsImp::takePosition (int seq, SHAMap::ref position)
 
 // Call with the master lock for now
 SHAMapAddNode NetworkOPsImp::gotTXData (const boost::shared_ptr<Peer>& peer, uint256 const& hash,
-                                     const std::list<SHAMapNode>& nodeIDs, const std::list< Blob >& nodeData)
+                                     const std::vector<SHAMapNode>& nodeIDs, const std::list< Blob >& nodeData)
 {
 
     if (!mConsensus)
@@ -1807,6 +1822,85 @@ NetworkOPsImp::transactionsSQL (std::string selection, const RippleAddress& acco
     return sql;
 }
 
+// Reads a column which may hold more than the first guess of its size
+static Blob readAccountTxBlob (Database* db, const char* column)
+{
+    int size = 2048;
+    Blob data (size);
+    size = db->getBinary (column, &data[0], data.size ());
+
+    if (size > data.size ())
+    {
+        data.resize (size);
+        db->getBinary (column, &data[0], data.size ());
+    }
+    else
+        data.resize (size);
+
+    return data;
+}
+
+NetworkOPsImp::AccountTxRow NetworkOPsImp::readAccountTxRow (Database* db)
+{
+    AccountTxRow row;
+    std::string transID;
+
+    db->getStr ("TransID", transID);
+    row.transID = uint256 (transID);
+    row.ledgerSeq = db->getInt ("LedgerSeq");
+    db->getStr ("Status", row.status);
+    row.rawTxn = readAccountTxBlob (db, "RawTxn");
+    row.rawMeta = readAccountTxBlob (db, "TxnMeta");
+
+    return row;
+}
+
+// Loads the blobs of a row which are kept only in the ledger.
+// Must be called without the database lock, since it may load the ledger.
+bool NetworkOPsImp::loadAccountTxBlobs (AccountTxRow& row)
+{
+    if (!row.rawTxn.empty () && (!row.rawMeta.empty () || getConfig ().TXN_DB_BLOBS))
+        return true;
+
+    Blob raw, meta;
+
+    if (Ledger::loadTransactionBlobs (row.ledgerSeq, row.transID, raw, meta))
+    {
+        if (row.rawTxn.empty ())
+            row.rawTxn.swap (raw);
+
+        if (row.rawMeta.empty ())
+            row.rawMeta.swap (meta);
+    }
+    else if (row.rawTxn.empty ())
+    {
+        m_journal.warning << "Transaction " << row.transID << " is missing from ledger " <<
+            row.ledgerSeq << " and is left out of the results";
+        return false;
+    }
+
+    return true;
+}
+
+Transaction::pointer NetworkOPsImp::loadAccountTx (AccountTxRow& row)
+{
+    if (!loadAccountTxBlobs (row))
+        return Transaction::pointer ();
+
+    Transaction::pointer txn (Transaction::transactionFromBlob (
+        row.rawTxn, row.status, row.ledgerSeq, false));
+
+    if (row.rawMeta.empty ())
+    { // Work around a bug that could leave the metadata missing
+        m_journal.warning << "Recovering ledger " << row.ledgerSeq << ", txn " << txn->getID();
+        Ledger::pointer ledger = getLedgerBySeq(row.ledgerSeq);
+        if (ledger)
+            ledger->pendSaveValidated(false, false);
+    }
+
+    return txn;
+}
+
 std::vector< std::pair<Transaction::pointer, TransactionMetaSet::pointer> >
 NetworkOPsImp::getAccountTxs (const RippleAddress& account, std::int32_t minLedger,
                               std::int32_t maxLedger, bool descending, std::uint32_t offset,
@@ -1815,44 +1909,28 @@ NetworkOPsImp::getAccountTxs (const RippleAddress& account, std::int32_t minLedg
     // can be called with no locks
     std::vector< std::pair<Transaction::pointer, TransactionMetaSet::pointer> > ret;
 
-    std::string sql = NetworkOPsImp::transactionsSQL ("AccountTransactions.LedgerSeq,Status,RawTxn,TxnMeta", account,
+    std::string sql = NetworkOPsImp::transactionsSQL ("AccountTransactions.TransID,AccountTransactions.LedgerSeq,Status,RawTxn,TxnMeta", account,
                       minLedger, maxLedger, descending, offset, limit, false, false, bAdmin);
 
+    std::vector<AccountTxRow> rows;
+
     {
         Database* db = getApp().getTxnDB ()->getDB ();
         DeprecatedScopedLock sl (getApp().getTxnDB ()->getDBLock ());
 
         SQL_FOREACH (db, sql)
         {
-            Transaction::pointer txn = Transaction::transactionFromSQL (db, false);
-
-            Serializer rawMeta;
-            int metaSize = 2048;
-            rawMeta.resize (metaSize);
-            metaSize = db->getBinary ("TxnMeta", &*rawMeta.begin (), rawMeta.getLength ());
-
-            if (metaSize > rawMeta.getLength ())
-            {
-                rawMeta.resize (metaSize);
-                db->getBinary ("TxnMeta", &*rawMeta.begin (), rawMeta.getLength ());
-            }
-            else
-                rawMeta.resize (metaSize);
-
-            if (rawMeta.getLength() == 0)
-            { // Work around a bug that could leave the metadata missing
-                std::uint32_t seq = static_cast<std::uint32_t>(db->getBigInt("LedgerSeq"));
-                m_journal.warning << "Recovering ledger " << seq << ", txn " << txn->getID();
-                Ledger::pointer ledger = getLedgerBySeq(seq);
-                if (ledger)
-                    ledger->pendSaveValidated(false, false);
-            }
+            rows.push_back (readAccountTxRow (db));
+        }
+    }
 
-            TransactionMetaSet::pointer meta = boost::make_shared<TransactionMetaSet> (txn->getID (), txn->getLedger (), rawMeta.getData ());
+    BOOST_FOREACH (AccountTxRow& row, rows)
+    {
+        Transaction::pointer txn (loadAccountTx (row));
 
-            // VFALCO NOTE Use emplace instead.
-            ret.push_back (std::pair<Transaction::ref, TransactionMetaSet::ref> (txn, meta));
-        }
+        if (txn)
+            ret.push_back (std::make_pair (txn, boost::make_shared<TransactionMetaSet> (
+                txn->getID (), txn->getLedger (), row.rawMeta)));
     }
 
     return ret;
@@ -1865,45 +1943,29 @@ std::vector<NetworkOPsImp::txnMetaLedgerType> NetworkOPsImp::getAccountTxsB (
     // can be called with no locks
     std::vector< txnMetaLedgerType> ret;
 
-    std::string sql = NetworkOPsImp::transactionsSQL ("AccountTransactions.LedgerSeq,Status,RawTxn,TxnMeta", account,
+    std::string sql = NetworkOPsImp::transactionsSQL ("AccountTransactions.TransID,AccountTransactions.LedgerSeq,Status,RawTxn,TxnMeta", account,
                       minLedger, maxLedger, descending, offset, limit, true/*binary*/, false, bAdmin);
 
+    std::vector<AccountTxRow> rows;
+
     {
         Database* db = getApp().getTxnDB ()->getDB ();
         DeprecatedScopedLock sl (getApp().getTxnDB ()->getDBLock ());
 
         SQL_FOREACH (db, sql)
         {
-            int txnSize = 2048;
-            Blob rawTxn (txnSize);
-            txnSize = db->getBinary ("RawTxn", &rawTxn[0], rawTxn.size ());
-
-            if (txnSize > rawTxn.size ())
-            {
-                rawTxn.resize (txnSize);
-                db->getBinary ("RawTxn", &*rawTxn.begin (), rawTxn.size ());
-            }
-            else
-                rawTxn.resize (txnSize);
-
-            int metaSize = 2048;
-            Blob rawMeta (metaSize);
-            metaSize = db->getBinary ("TxnMeta", &rawMeta[0], rawMeta.size ());
-
-            if (metaSize > rawMeta.size ())
-            {
-                rawMeta.resize (metaSize);
-                db->getBinary ("TxnMeta", &*rawMeta.begin (), rawMeta.size ());
-            }
-            else
-                rawMeta.resize (metaSize);
+            rows.push_back (readAccountTxRow (db));
+        }
+    }
 
-            // VFALCO TODO Change the container's type to be std::tuple so
-            //             we can use std::forward_as_tuple here
-            //
+    BOOST_FOREACH (AccountTxRow& row, rows)
+    {
+        // VFALCO TODO Change the container's type to be std::tuple so
+        //             we can use std::forward_as_tuple here
+        //
+        if (loadAccountTxBlobs (row))
             ret.push_back (std::make_tuple (
-                strHex (rawTxn), strHex (rawMeta), db->getInt ("LedgerSeq")));
-        }
+                strHex (row.rawTxn), strHex (row.rawMeta), row.ledgerSeq));
     }
 
     return ret;
@@ -1952,7 +2014,7 @@ NetworkOPsImp::getTxsAccount (const RippleAddress& account, std::int32_t minLedg
     token = Json::nullValue;
 
     std::string sql = boost::str (boost::format
-        ("SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,Status,RawTxn,TxnMeta "
+        ("SELECT AccountTransactions.TransID,AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,Status,RawTxn,TxnMeta "
          "FROM AccountTransactions INNER JOIN Transactions ON Transactions.TransID = AccountTransactions.TransID "
          "WHERE AccountTransactions.Account = '%s' AND AccountTransactions.LedgerSeq BETWEEN '%u' AND '%u' "
          "ORDER BY AccountTransactions.LedgerSeq %s, AccountTransactions.TxnSeq %s, AccountTransactions.TransID %s "
@@ -1964,6 +2026,9 @@ NetworkOPsImp::getTxsAccount (const RippleAddress& account, std::int32_t minLedg
              % (forward ? "ASC" : "DESC")
              % (forward ? "ASC" : "DESC")
              % queryLimit);
+
+    std::vector<AccountTxRow> rows;
+
     {
         Database* db = getApp().getTxnDB ()->getDB ();
         DeprecatedScopedLock sl (getApp().getTxnDB ()->getDBLock ());
@@ -1985,38 +2050,21 @@ NetworkOPsImp::getTxsAccount (const RippleAddress& account, std::int32_t minLedg
 
             if (foundResume)
             {
-                Transaction::pointer txn = Transaction::transactionFromSQL (db, false);
-
-                Serializer rawMeta;
-                int metaSize = 2048;
-                rawMeta.resize (metaSize);
-                metaSize = db->getBinary ("TxnMeta", &*rawMeta.begin (), rawMeta.getLength ());
-
-                if (metaSize > rawMeta.getLength ())
-                {
-                    rawMeta.resize (metaSize);
-                    db->getBinary ("TxnMeta", &*rawMeta.begin (), rawMeta.getLength ());
-                }
-                else
-                    rawMeta.resize (metaSize);
-
-                if (rawMeta.getLength() == 0)
-                { // Work around a bug that could leave the metadata missing
-                    std::uint32_t seq = static_cast<std::uint32_t>(db->getBigInt("LedgerSeq"));
-                    m_journal.warning << "Recovering ledger " << seq << ", txn " << txn->getID();
-                    Ledger::pointer ledger = getLedgerBySeq(seq);
-                    if (ledger)
-                        ledger->pendSaveValidated(false, false);
-                }
-
+                rows.push_back (readAccountTxRow (db));
                 --numberOfResults;
-                TransactionMetaSet::pointer meta = boost::make_shared<TransactionMetaSet> (txn->getID (), txn->getLedger (), rawMeta.getData ());
-
-                ret.push_back (std::pair<Transaction::ref, TransactionMetaSet::ref> (txn, meta));
             }
         }
     }
 
+    BOOST_FOREACH (AccountTxRow& row, rows)
+    {
+        Transaction::pointer txn (loadAccountTx (row));
+
+        if (txn)
+            ret.push_back (std::make_pair (txn, boost::make_shared<TransactionMetaSet> (
+                txn->getID (), txn->getLedger (), row.rawMeta)));
+    }
+
     return ret;
 }
 
@@ -2060,7 +2108,7 @@ NetworkOPsImp::getTxsAccountB (const RippleAddress& account, std::int32_t minLed
     token = Json::nullValue;
 
     std::string sql = boost::str (boost::format
-        ("SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,Status,RawTxn,TxnMeta "
+        ("SELECT AccountTransactions.TransID,AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,Status,RawTxn,TxnMeta "
          "FROM AccountTransactions INNER JOIN Transactions ON Transactions.TransID = AccountTransactions.TransID "
          "WHERE AccountTransactions.Account = '%s' AND AccountTransactions.LedgerSeq BETWEEN '%u' AND '%u' "
          "ORDER BY AccountTransactions.LedgerSeq %s, AccountTransactions.TxnSeq %s, AccountTransactions.TransID %s "
@@ -2072,6 +2120,9 @@ NetworkOPsImp::getTxsAccountB (const RippleAddress& account, std::int32_t minLed
              % (forward ? "ASC" : "DESC")
              % (forward ? "ASC" : "DESC")
              % queryLimit);
+
+    std::vector<AccountTxRow> rows;
+
     {
         Database* db = getApp().getTxnDB ()->getDB ();
         DeprecatedScopedLock sl (getApp().getTxnDB ()->getDBLock ());
@@ -2093,37 +2144,19 @@ NetworkOPsImp::getTxsAccountB (const RippleAddress& account, std::int32_t minLed
 
             if (foundResume)
             {
-                int txnSize = 2048;
-                Blob rawTxn (txnSize);
-                txnSize = db->getBinary ("RawTxn", &rawTxn[0], rawTxn.size ());
-
-                if (txnSize > rawTxn.size ())
-                {
-                    rawTxn.resize (txnSize);
-                    db->getBinary ("RawTxn", &*rawTxn.begin (), rawTxn.size ());
-                }
-                else
-                    rawTxn.resize (txnSize);
-
-                int metaSize = 2048;
-                Blob rawMeta (metaSize);
-                metaSize = db->getBinary ("TxnMeta", &rawMeta[0], rawMeta.size ());
-
-                if (metaSize > rawMeta.size ())
-                {
-                    rawMeta.resize (metaSize);
-                    db->getBinary ("TxnMeta", &*rawMeta.begin (), rawMeta.size ());
-                }
-                else
-                    rawMeta.resize (metaSize);
-
-                ret.push_back (std::make_tuple (
-                    strHex (rawTxn), strHex (rawMeta), db->getInt ("LedgerSeq")));
+                rows.push_back (readAccountTxRow (db));
                 --numberOfResults;
             }
         }
     }
 
+    BOOST_FOREACH (AccountTxRow& row, rows)
+    {
+        if (loadAccountTxBlobs (row))
+            ret.push_back (std::make_tuple (
+                strHex (row.rawTxn), strHex (row.rawMeta), row.ledgerSeq));
+    }
+
     return ret;
 }
 
@@ -2231,8 +2264,14 @@ Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
     //      info["consensus"] = mConsensus->getJson();
 
     if (admin)
+    {
         info["load"] = getApp().getJobQueue ().getJson ();
 
+        info["node_size"] = getConfig ().getNodeSizeName ();
+        if (getConfig ().NODE_SIZE_AUTO)
+            info["node_size_auto"] = true;
+    }
+
     if (!human)
     {
         info["load_base"] = getApp().getFeeTrack ().getLoadBase ();
@@ -62,6 +62,16 @@ SerializedTransaction::SerializedTransaction (STObject const& object)
     }
 }
 
+SerializedTransaction::SerializedTransaction (SerializedTransaction const& other)
+    : STObject (other)
+    , CountedObject <SerializedTransaction> (other)
+    , mType (other.mType)
+    , mFormat (other.mFormat)
+    , mSigGood (other.mSigGood.load ())
+    , mSigBad (other.mSigBad.load ())
+{
+}
+
 SerializedTransaction::SerializedTransaction (SerializerIterator& sit) : STObject (sfTransaction),
     mSigGood (false), mSigBad (false)
 {
@@ -191,10 +201,10 @@ void SerializedTransaction::sign (const RippleAddress& naAccountPrivate)
 
 bool SerializedTransaction::checkSign () const
 {
-    if (mSigGood)
+    if (mSigGood.load ())
         return true;
 
-    if (mSigBad)
+    if (mSigBad.load ())
         return false;
 
     try
@@ -204,7 +214,7 @@ bool SerializedTransaction::checkSign () const
 
         if (checkSign (n))
         {
-            mSigGood = true;
+            mSigGood.store (true);
             return true;
         }
     }
@@ -213,7 +223,7 @@ bool SerializedTransaction::checkSign () const
         ;
     }
 
-    mSigBad = true;
+    mSigBad.store (true);
     return false;
 }
 
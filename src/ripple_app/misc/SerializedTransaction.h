@@ -45,6 +45,7 @@ public:
     SerializedTransaction (SerializerIterator & sit);
     SerializedTransaction (TxType type);
     SerializedTransaction (const STObject & object);
+    SerializedTransaction (SerializedTransaction const& other);
 
     // STObject functions
     SerializedTypeID getSType () const
@@ -111,19 +112,19 @@ public:
     bool checkSign () const;
     bool isKnownGood () const
     {
-        return mSigGood;
+        return mSigGood.load ();
     }
     bool isKnownBad () const
     {
-        return mSigBad;
+        return mSigBad.load ();
     }
     void setGood () const
     {
-        mSigGood = true;
+        mSigGood.store (true);
     }
     void setBad () const
     {
-        mSigBad = true;
+        mSigBad.store (true);
     }
 
     // SQL Functions
@@ -149,8 +150,9 @@ private:
         return new SerializedTransaction (*this);
     }
 
-    mutable bool mSigGood;
-    mutable bool mSigBad;
+    // TransactionMaster shares one parsed transaction between threads
+    mutable std::atomic <bool> mSigGood;
+    mutable std::atomic <bool> mSigBad;
 };
 
 bool passesLocalChecks (STObject const& st, std::string&);
@@ -461,9 +461,10 @@ private:
         mWriting = false;
     }
 
+    // The cache has its own lock, and only lets go of sets nobody else
+    // holds, so holding ours would just block validations for the sweep.
     void sweep ()
     {
-        ScopedLockType sl (mLock);
         mValidations.sweep ();
     }
 };
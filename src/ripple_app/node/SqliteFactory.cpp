@@ -145,6 +145,21 @@ public:
         pStE.reset();
     }
 
+    void remove (void const* key)
+    {
+        DeprecatedScopedLock sl (m_db->getDBLock());
+
+        uint256 const hash (uint256::fromVoid (key));
+
+        static SqliteStatement pSt (m_db->getDB()->getSqliteDB(),
+            "DELETE FROM CommittedObjects WHERE Hash = ?;");
+
+        pSt.bind (1, hash.GetHex());
+
+        pSt.step();
+        pSt.reset();
+    }
+
     void visitAll (NodeStore::VisitCallback& callback)
     {
         // No lock needed as per the visitAll() API
@@ -21,27 +21,93 @@ namespace ripple {
 
 /** Get the current RippleLineCache, updating it if necessary.
     Get the correct ledger to use.
+    Must not be called with the lock held: the trust line graph is built
+    without it, so that new requests and get_counts are not held up.
 */
 RippleLineCache::pointer PathRequests::getLineCache (Ledger::pointer& ledger, bool authoritative)
 {
+    RippleLineCache::pointer current;
+    TrustLineGraph::pointer previous;
+
+    {
+        ScopedLockType sl (mLock);
+
+        std::uint32_t lineSeq = mLineCache ? mLineCache->getLedger()->getLedgerSeq() : 0;
+        std::uint32_t lgrSeq = ledger->getLedgerSeq();
+
+        bool const update =
+            (lineSeq == 0) ||                                 // no ledger
+            (authoritative && (lgrSeq > lineSeq)) ||          // newer authoritative ledger
+            (authoritative && ((lgrSeq + 8)  < lineSeq)) ||   // we jumped way back for some reason
+            (lgrSeq > (lineSeq + 8));                         // we jumped way forward for some reason
+
+        if (!update)
+        {
+            ledger = mLineCache->getLedger();
+            return mLineCache;
+        }
+
+        current = mLineCache;
+        previous = mGraph;
+    }
+
+    ledger = boost::make_shared<Ledger>(*ledger, false); // Take a snapshot of the ledger
+
+    TrustLineGraph::pointer graph;
+    bool const buildGraph (authoritative && getConfig ().PATH_GRAPH);
+
+    if (buildGraph)
+        graph = makeGraph (ledger, previous);
+
     ScopedLockType sl (mLock);
 
-    std::uint32_t lineSeq = mLineCache ? mLineCache->getLedger()->getLedgerSeq() : 0;
-    std::uint32_t lgrSeq = ledger->getLedgerSeq();
+    if (buildGraph && (mGraph == previous))
+        mGraph = graph;
 
-    if ( (lineSeq == 0) ||                                 // no ledger
-         (authoritative && (lgrSeq > lineSeq)) ||          // newer authoritative ledger
-         (authoritative && ((lgrSeq + 8)  < lineSeq)) ||   // we jumped way back for some reason
-         (lgrSeq > (lineSeq + 8)))                         // we jumped way forward for some reason
+    // Another caller replaced the cache while we were building
+    if ((mLineCache != current) && mLineCache &&
+        (mLineCache->getLedger()->getLedgerSeq() >= ledger->getLedgerSeq()))
     {
-        ledger = boost::make_shared<Ledger>(*ledger, false); // Take a snapshot of the ledger
-        mLineCache = boost::make_shared<RippleLineCache> (ledger);
+        ledger = mLineCache->getLedger();
+        return mLineCache;
     }
+
+    if (mGraph && (mGraph->getLedgerSeq () == ledger->getLedgerSeq ()))
+        mLineCache = boost::make_shared<RippleLineCache> (ledger, mGraph);
     else
+        mLineCache = boost::make_shared<RippleLineCache> (ledger);
+
+    return mLineCache;
+}
+
+/** Build the trust line graph of a ledger snapshot.
+    The graph of the previous ledger is used to only read what changed.
+*/
+TrustLineGraph::pointer PathRequests::makeGraph (Ledger::ref ledger,
+    TrustLineGraph::pointer const& previous)
+{
+    try
     {
-        ledger = mLineCache->getLedger();
+        TrustLineGraph::pointer const graph (TrustLineGraph::build (ledger, previous));
+
+        mJournal.debug << "Trust line graph for ledger " << graph->getLedgerSeq () <<
+            ": " << graph->getLineCount () << " lines, " << graph->getMemoryUsed () <<
+            " bytes, built in " << graph->getBuildMilliseconds () << "ms";
+
+        return graph;
     }
-    return mLineCache;
+    catch (SHAMapMissingNode const& e)
+    {
+        mJournal.info << "Unable to build trust line graph: " << e;
+    }
+
+    return TrustLineGraph::pointer ();
+}
+
+TrustLineGraph::pointer PathRequests::getGraph ()
+{
+    ScopedLockType sl (mLock);
+    return mGraph;
 }
 
 void PathRequests::updateAll (Ledger::ref inLedger, CancelCallback shouldCancel)
@@ -56,8 +122,8 @@ void PathRequests::updateAll (Ledger::ref inLedger, CancelCallback shouldCancel)
     {
         ScopedLockType sl (mLock);
         requests = mRequests;
-        cache = getLineCache (ledger, true);
     }
+    cache = getLineCache (ledger, true);
 
     bool newRequests = getApp().getLedgerMaster().isNewPathRequest();
     bool mustBreak = false;
@@ -148,10 +214,10 @@ void PathRequests::updateAll (Ledger::ref inLedger, CancelCallback shouldCancel)
             if (mRequests.empty())
                 break;
             requests = mRequests;
-
-            cache = getLineCache (ledger, false);
         }
 
+        cache = getLineCache (ledger, false);
+
     }
     while (!shouldCancel ());
 
@@ -168,12 +234,7 @@ Json::Value PathRequests::makePathRequest(
         subscriber, ++mLastIdentifier, *this, mJournal);
 
     Ledger::pointer ledger = inLedger;
-    RippleLineCache::pointer cache;
-
-    {
-        ScopedLockType sl (mLock);
-        cache = getLineCache (ledger, false);
-    }
+    RippleLineCache::pointer cache (getLineCache (ledger, false));
 
     bool valid = false;
     Json::Value result = req->doCreate (ledger, cache, requestJson, valid);
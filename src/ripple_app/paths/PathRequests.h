@@ -37,6 +37,9 @@ public:
 
     RippleLineCache::pointer getLineCache (Ledger::pointer& ledger, bool authoritative);
 
+    // Returns the trust line graph, if there is one
+    TrustLineGraph::pointer getGraph ();
+
     Json::Value makePathRequest (
         boost::shared_ptr <InfoSub> const& subscriber,
         const boost::shared_ptr<Ledger>& ledger,
@@ -53,6 +56,9 @@ public:
     }
 
 private:
+    TrustLineGraph::pointer makeGraph (Ledger::ref ledger,
+        TrustLineGraph::pointer const& previous);
+
     beast::Journal                   mJournal;
 
     beast::insight::Event            mFast;
@@ -64,6 +70,9 @@ private:
     // Use a RippleLineCache
     RippleLineCache::pointer         mLineCache;
 
+    // The graph of every trust line, with [path_graph]
+    TrustLineGraph::pointer          mGraph;
+
     beast::Atomic<int>               mLastIdentifier;
 
     typedef RippleRecursiveMutex     LockType;
@@ -103,7 +103,9 @@ Pathfinder::Pathfinder (RippleLineCache::ref cache,
         mSrcCurrencyID (uSrcCurrencyID),
         mSrcIssuerID (uSrcIssuerID),
         mSrcAmount (uSrcCurrencyID, uSrcIssuerID, 1u, 0, true),
-        mLedger (cache->getLedger ()), mRLCache (cache)
+        mLedger (cache->getLedger ()), mRLCache (cache),
+        mAccountExpansions (0), mAccountReuses (0),
+        mBookLookups (0), mBookReuses (0)
 {
 
     if ((mSrcAccountID == mDstAccountID && mSrcCurrencyID == mDstAmount.getCurrency ()) || mDstAmount == zero)
@@ -201,6 +203,9 @@ bool Pathfinder::findPaths (int iLevel, const unsigned int iMaxPaths, STPathSet&
     }
 
     WriteLog (lsDEBUG, Pathfinder) << mCompletePaths.size() << " complete paths found";
+    WriteLog (lsDEBUG, Pathfinder) <<
+        mAccountExpansions << " account expansions (" << mAccountReuses << " reused), " <<
+        mBookLookups << " book lookups (" << mBookReuses << " reused)";
 
     BOOST_FOREACH(const STPath& path, pathsOut)
     { // make sure no paths were lost
@@ -407,17 +412,18 @@ boost::unordered_set<uint160> usAccountSourceCurrencies (
         usCurrencies.insert (uint160 (CURRENCY_XRP));
 
     // List of ripple lines.
-    AccountItems& rippleLines (lrCache->getRippleLines (raAccountID.getAccountID ()));
+    TrustLineGraph::Lines const rippleLines (lrCache->getLines (raAccountID.getAccountID ()));
 
-    BOOST_FOREACH (AccountItem::ref item, rippleLines.getItems ())
+    for (std::size_t i = 0; i < rippleLines.size (); ++i)
     {
-        RippleState*    rspEntry    = (RippleState*) item.get ();
-        const STAmount& saBalance   = rspEntry->getBalance ();
+        TrustLineGraph::TrustLine const rspEntry (rippleLines[i]);
+        const STAmount  saBalance   = rspEntry.getBalance ();
+        const STAmount  saLimitPeer = rspEntry.getLimitPeer ();
 
         // Filter out non
         if (saBalance > zero                             // Have IOUs to send.
-                || (rspEntry->getLimitPeer ()                       // Peer extends credit.
-                    && ((-saBalance) < rspEntry->getLimitPeer ()))) // Credit left.
+                || (saLimitPeer                                     // Peer extends credit.
+                    && ((-saBalance) < saLimitPeer)))               // Credit left.
         {
             usCurrencies.insert (saBalance.getCurrency ());
         }
@@ -438,14 +444,14 @@ boost::unordered_set<uint160> usAccountDestCurrencies (
         usCurrencies.insert (uint160 (CURRENCY_XRP)); // Even if account doesn't exist
 
     // List of ripple lines.
-    AccountItems& rippleLines (lrCache->getRippleLines (raAccountID.getAccountID ()));
+    TrustLineGraph::Lines const rippleLines (lrCache->getLines (raAccountID.getAccountID ()));
 
-    BOOST_FOREACH (AccountItem::ref item, rippleLines.getItems ())
+    for (std::size_t i = 0; i < rippleLines.size (); ++i)
     {
-        RippleState*    rspEntry    = (RippleState*) item.get ();
-        const STAmount& saBalance   = rspEntry->getBalance ();
+        TrustLineGraph::TrustLine const rspEntry (rippleLines[i]);
+        const STAmount  saBalance   = rspEntry.getBalance ();
 
-        if (saBalance < rspEntry->getLimit ())                  // Can take more
+        if (saBalance < rspEntry.getLimit ())                   // Can take more
             usCurrencies.insert (saBalance.getCurrency ());
     }
 
@@ -487,22 +493,22 @@ int Pathfinder::getPathsOut (RippleCurrency const& currencyID, const uint160& ac
     bool const bAuthRequired = (aFlags & lsfRequireAuth) != 0;
 
     int count = 0;
-    AccountItems& rippleLines (mRLCache->getRippleLines (accountID));
+    TrustLineGraph::Lines const rippleLines (mRLCache->getLines (accountID));
 
-    BOOST_FOREACH (AccountItem::ref item, rippleLines.getItems ())
+    for (std::size_t i = 0; i < rippleLines.size (); ++i)
     {
-        RippleState* rspEntry = (RippleState*) item.get ();
+        TrustLineGraph::TrustLine const rspEntry (rippleLines[i]);
 
-        if (currencyID != rspEntry->getLimit ().getCurrency ())
+        if (currencyID != rspEntry.getCurrency ())
             nothing ();
-        else if (rspEntry->getBalance () <= zero &&
-                 (!rspEntry->getLimitPeer ()
-                  || -rspEntry->getBalance () >= rspEntry->getLimitPeer ()
-                  ||  (bAuthRequired && !rspEntry->getAuth ())))
+        else if (rspEntry.getBalance () <= zero &&
+                 (!rspEntry.getLimitPeer ()
+                  || -rspEntry.getBalance () >= rspEntry.getLimitPeer ()
+                  ||  (bAuthRequired && !rspEntry.getAuth ())))
             nothing ();
-        else if (isDstCurrency && (dstAccount == rspEntry->getAccountIDPeer ()))
+        else if (isDstCurrency && (dstAccount == rspEntry.getAccountIDPeer ()))
             count += 10000; // count a path to the destination extra
-        else if (rspEntry->getNoRipplePeer ())
+        else if (rspEntry.getNoRipplePeer ())
             nothing (); // This probably isn't a useful path out
         else
             ++count;
@@ -511,6 +517,108 @@ int Pathfinder::getPathsOut (RippleCurrency const& currencyID, const uint160& ac
     return count;
 }
 
+// Scans the account's ripple lines once per request for each currency and
+// arrival kind, rather than once per partial path ending on the account.
+// What is left to check per path, whether a candidate is already on it,
+// is done by the caller.
+Pathfinder::AccountCandidates const& Pathfinder::getAccountCandidates (
+    const uint160& accountID, const uint160& currencyID, bool isNoRippleOut)
+{
+    std::pair<uint160, uint160> const key (accountID, currencyID);
+    ripple::unordered_map<std::pair<uint160, uint160>, AccountCandidates>& acMap (
+        mACMap[isNoRippleOut ? 1 : 0]);
+    ripple::unordered_map<std::pair<uint160, uint160>, AccountCandidates>::iterator it = acMap.find (key);
+
+    if (it != acMap.end ())
+    {
+        ++mAccountReuses;
+        return it->second;
+    }
+
+    ++mAccountExpansions;
+
+    AccountCandidates& ac (acMap[key]);
+    ac.accountExists = false;
+    ac.reachesDestination = false;
+
+    SLE::pointer sleEnd = mLedger->getSLEi(Ledger::getAccountRootIndex(accountID));
+    if (!sleEnd)
+        return ac;
+
+    ac.accountExists = true;
+
+    bool const bRequireAuth = is_bit_set(sleEnd->getFieldU32(sfFlags), lsfRequireAuth);
+    bool const bIsEndCurrency = (currencyID == mDstAmount.getCurrency());
+
+    TrustLineGraph::Lines const rippleLines (mRLCache->getLines(accountID));
+
+    ac.candidates.reserve(rippleLines.size());
+
+    for (std::size_t i = 0; i < rippleLines.size(); ++i)
+    {
+        TrustLineGraph::TrustLine const rspEntry (rippleLines[i]);
+        uint160 const& acctID = rspEntry.getAccountIDPeer();
+
+        if (currencyID != rspEntry.getCurrency())
+        {
+            // wrong currency
+        }
+        else if (rspEntry.getBalance() <= zero
+            && (!rspEntry.getLimitPeer()
+                || -rspEntry.getBalance() >= rspEntry.getLimitPeer()
+                || (bRequireAuth && !rspEntry.getAuth())))
+        {
+            // path has no credit
+        }
+        else if (isNoRippleOut && rspEntry.getNoRipple())
+        {
+            // Can't leave on this path
+        }
+        else if (acctID == mDstAccountID)
+        { // destination is always worth trying
+            if (bIsEndCurrency)
+                ac.reachesDestination = true;
+            else
+                ac.candidates.push_back(std::make_pair(100000, acctID));
+        }
+        else if (acctID == mSrcAccountID)
+        {
+            // going back to the source is bad
+        }
+        else
+        { // save this candidate
+            int out = getPathsOut(currencyID, acctID, bIsEndCurrency, mDstAccountID);
+            if (out)
+                ac.candidates.push_back(std::make_pair(out, acctID));
+        }
+    }
+
+    std::sort (ac.candidates.begin(), ac.candidates.end(),
+        BIND_TYPE(candCmp, mLedger->getLedgerSeq(), P_1, P_2));
+
+    return ac;
+}
+
+std::vector<OrderBook::pointer> const& Pathfinder::getBooksOut (
+    const uint160& issuerID, const uint160& currencyID)
+{
+    std::pair<uint160, uint160> const key (issuerID, currencyID);
+    ripple::unordered_map<std::pair<uint160, uint160>,
+        std::vector<OrderBook::pointer> >::iterator it = mBookMap.find (key);
+
+    if (it != mBookMap.end ())
+    {
+        ++mBookReuses;
+        return it->second;
+    }
+
+    ++mBookLookups;
+
+    std::vector<OrderBook::pointer>& books (mBookMap[key]);
+    getApp().getOrderBookDB().getBooksByTakerPays(issuerID, currencyID, books);
+    return books;
+}
+
 void Pathfinder::addLink(
     const STPathSet& currentPaths,  // The paths to build from
     STPathSet& incompletePaths,     // The set of partial paths we add to
@@ -643,84 +751,33 @@ void Pathfinder::addLink(
         }
         else
         { // search for accounts to add
-            SLE::pointer sleEnd = mLedger->getSLEi(Ledger::getAccountRootIndex(uEndAccount));
-            if (sleEnd)
-            {
-                bool const bRequireAuth = is_bit_set(sleEnd->getFieldU32(sfFlags), lsfRequireAuth);
-                bool const bIsEndCurrency = (uEndCurrency == mDstAmount.getCurrency());
-                bool const bIsNoRippleOut = isNoRippleOut (currentPath);
-
-                AccountItems& rippleLines (mRLCache->getRippleLines(uEndAccount));
+            AccountCandidates const& ac (getAccountCandidates (
+                uEndAccount, uEndCurrency, isNoRippleOut (currentPath)));
 
-                std::vector< std::pair<int, uint160> > candidates;
-                candidates.reserve(rippleLines.getItems().size());
-
-                BOOST_FOREACH(AccountItem::ref item, rippleLines.getItems())
-                {
-                    RippleState const& rspEntry = * reinterpret_cast<RippleState const *>(item.get());
-                    uint160 const& acctID = rspEntry.getAccountIDPeer();
-
-                    if ((uEndCurrency == rspEntry.getLimit().getCurrency()) &&
-                        !currentPath.hasSeen(acctID, uEndCurrency, acctID))
-                    { // path is for correct currency and has not been seen
-                        if (rspEntry.getBalance() <= zero
-                            && (!rspEntry.getLimitPeer()
-                                || -rspEntry.getBalance() >= rspEntry.getLimitPeer()
-                                || (bRequireAuth && !rspEntry.getAuth())))
-                        {
-                            // path has no credit
-                        }
-                        else if (bIsNoRippleOut && rspEntry.getNoRipple())
-                        {
-                            // Can't leave on this path
-                        }
-                        else if (acctID == mDstAccountID)
-                        { // destination is always worth trying
-                            if (uEndCurrency == mDstAmount.getCurrency())
-                            { // this is a complete path
-                                if (!currentPath.isEmpty())
-                                {
-                                    WriteLog (lsTRACE, Pathfinder) << "complete path found ae: " << currentPath.getJson(0);
-                                    mCompletePaths.addUniquePath(currentPath);
-                                }
-                            }
-                            else if ((addFlags & afAC_LAST) == 0)
-                            { // this is a high-priority candidate
-                                candidates.push_back(std::make_pair(100000, acctID));
-                            }
-                        }
-                        else if (acctID == mSrcAccountID)
-                        {
-                            // going back to the source is bad
-                        }
-                        else if ((addFlags & afAC_LAST) == 0)
-                        { // save this candidate
-                            int out = getPathsOut(uEndCurrency, acctID, bIsEndCurrency, mDstAccountID);
-                            if (out)
-                                candidates.push_back(std::make_pair(out, acctID));
-                        }
-                    }
+            if (ac.accountExists)
+            {
+                if (ac.reachesDestination && !currentPath.isEmpty() &&
+                    !currentPath.hasSeen(mDstAccountID, uEndCurrency, mDstAccountID))
+                { // this is a complete path
+                    WriteLog (lsTRACE, Pathfinder) << "complete path found ae: " << currentPath.getJson(0);
+                    mCompletePaths.addUniquePath(currentPath);
                 }
 
-                if (!candidates.empty())
+                if ((addFlags & afAC_LAST) == 0)
                 {
-                    std::sort (candidates.begin(), candidates.end(),
-                        BIND_TYPE(candCmp, mLedger->getLedgerSeq(), P_1, P_2));
-
-                    int count = candidates.size();
-                    if ((count > 10) && (uEndAccount != mSrcAccountID)) // allow more paths from source
-                        count = 10;
-                    else if (count > 50)
-                        count = 50;
-
-                    std::vector< std::pair<int, uint160> >::const_iterator it = candidates.begin();
-                    while (count-- != 0)
-                    { // Add accounts to incompletePaths
-                        incompletePaths.assembleAdd(currentPath, STPathElement(STPathElement::typeAccount, it->second, uEndCurrency, it->second));
-                        ++it;
+                    // allow more paths from source
+                    int count = (uEndAccount != mSrcAccountID) ? 10 : 50;
+
+                    std::vector<Candidate_t>::const_iterator it = ac.candidates.begin();
+                    for (; (count != 0) && (it != ac.candidates.end()); ++it)
+                    {
+                        if (!currentPath.hasSeen(it->second, uEndCurrency, it->second))
+                        { // Add accounts to incompletePaths
+                            incompletePaths.assembleAdd(currentPath, STPathElement(STPathElement::typeAccount, it->second, uEndCurrency, it->second));
+                            --count;
+                        }
                     }
                 }
-
             }
             else
             {
@@ -740,8 +797,7 @@ void Pathfinder::addLink(
         else
         {
             bool bDestOnly = (addFlags & afOB_LAST) != 0;
-            std::vector<OrderBook::pointer> books;
-            getApp().getOrderBookDB().getBooksByTakerPays(uEndIssuer, uEndCurrency, books);
+            std::vector<OrderBook::pointer> const& books (getBooksOut (uEndIssuer, uEndCurrency));
             WriteLog (lsTRACE, Pathfinder) << books.size() << " books found from this currency/issuer";
             BOOST_FOREACH(OrderBook::ref book, books)
             {
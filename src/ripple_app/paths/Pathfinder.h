@@ -90,6 +90,19 @@ private:
     typedef std::pair<int, PathType_t>    CostedPath_t;
     typedef std::vector<CostedPath_t>     CostedPathList_t;
 
+    typedef std::pair<int, uint160>       Candidate_t;
+
+    // The accounts a path ending on an account can be extended to.
+    // Only depends on the account, the currency and whether the path
+    // arrived on a no ripple link, so it is shared by every path that
+    // ends there.
+    struct AccountCandidates
+    {
+        bool                        accountExists;
+        bool                        reachesDestination; // credit to the destination in its currency
+        std::vector<Candidate_t>    candidates;         // best first, includes the destination
+    };
+
     // returns true if any building paths are now complete?
     bool checkComplete (STPathSet& retPathSet);
 
@@ -100,6 +113,11 @@ private:
     int getPathsOut (const uint160& currency, const uint160& accountID,
                      bool isDestCurrency, const uint160& dest);
 
+    AccountCandidates const& getAccountCandidates (const uint160& accountID,
+                                                   const uint160& currency, bool isNoRippleOut);
+
+    std::vector<OrderBook::pointer> const& getBooksOut (const uint160& issuer, const uint160& currency);
+
     void addLink(const STPath& currentPath, STPathSet& incompletePaths, int addFlags);
     void addLink(const STPathSet& currentPaths, STPathSet& incompletePaths, int addFlags);
     STPathSet& getPaths(const PathType_t& type, bool addComplete = true);
@@ -131,6 +149,19 @@ private:
     ripple::unordered_map<uint160, AccountItems::pointer>    mRLMap;
     ripple::unordered_map<std::pair<uint160, uint160>, int>  mPOMap;
 
+    // Expansions already computed for this request, by account and
+    // currency. Indexed by whether the path arrived on a no ripple link.
+    ripple::unordered_map<std::pair<uint160, uint160>, AccountCandidates> mACMap[2];
+
+    // Order books out of each issuer and currency
+    ripple::unordered_map<std::pair<uint160, uint160>,
+                          std::vector<OrderBook::pointer> >          mBookMap;
+
+    int                 mAccountExpansions;     // Number of ripple line scans
+    int                 mAccountReuses;         // Number of scans avoided
+    int                 mBookLookups;           // Number of order book index lookups
+    int                 mBookReuses;            // Number of lookups avoided
+
     static const std::uint32_t afADD_ACCOUNTS = 0x001;  // Add ripple paths
     static const std::uint32_t afADD_BOOKS    = 0x002;  // Add order books
     static const std::uint32_t afOB_XRP       = 0x010;  // Add order book to XRP only
@@ -1978,6 +1978,158 @@ void RippleCalc::pathNext (PathState::ref psrCur, const bool bMultiQuality, cons
     }
 }
 
+// The increments of a pass, shared between the thread computing the pass
+// and the jobs helping it. A helper holds this by shared pointer, so one
+// which only starts after the pass is over finds nothing left to claim and
+// touches nothing else.
+class PathsNextWork
+{
+public:
+    PathsNextWork (std::size_t count, std::function <void (std::size_t)> const& task)
+        : m_count (count)
+        , m_task (task)
+        , m_next (0)
+        , m_done (0)
+    {
+    }
+
+    // Compute increments until none are left to claim
+    void run ()
+    {
+        for (std::size_t i; (i = m_next++) < m_count;)
+        {
+            m_task (i);
+
+            std::lock_guard <std::mutex> lock (m_mutex);
+
+            if (++m_done == m_count)
+                m_cond.notify_all ();
+        }
+    }
+
+    // Wait for the increments claimed by helpers to be computed
+    void wait ()
+    {
+        std::unique_lock <std::mutex> lock (m_mutex);
+
+        while (m_done != m_count)
+            m_cond.wait (lock);
+    }
+
+private:
+    std::size_t const                       m_count;
+    std::function <void (std::size_t)> const m_task;
+    std::atomic <std::size_t>               m_next;
+    std::size_t                             m_done;
+    std::mutex                              m_mutex;
+    std::condition_variable                 m_cond;
+};
+
+// Compute the next increment of every active path, concurrently.
+// Each increment only depends on the checkpoint, so each path gets its own
+// RippleCalc and LedgerEntrySet and the results can be consumed in path order
+// afterwards, as if they had been computed one at a time.
+// The calling thread computes increments itself, and jtPATH_CALC jobs help it.
+// The job queue bounds how many of those run at once across all requests,
+// and the caller never waits for a helper which hasn't started.
+// The increments are computed without multiple qualities. If the last path may
+// turn out to be the only one with liquidity, pspLast receives a copy of its
+// state from before the increment so that it can be recomputed.
+// vbActive tells which paths were active before the pass: a path which ran dry
+// computing its increment has no quality left, but still counts as dry in the pass.
+// Returns false, computing nothing, if too few paths are active to be worth it.
+bool RippleCalc::pathsNext (std::vector<PathState::pointer>& vpsExpanded, const STAmount& saInAct, const STAmount& saOutAct,
+                            const LedgerEntrySet& lesCheckpoint, std::vector<LedgerEntrySet>& vlesNext,
+                            std::vector< boost::unordered_set<uint256> >& vusUnfunded, std::vector<bool>& vbActive,
+                            PathState::pointer& pspLast)
+{
+    // Fewest active paths for which helpers are worth starting
+    static std::size_t const minConcurrentPaths = 4;
+
+    // Most helper jobs queued for one pass
+    static std::size_t const maxHelpers = 3;
+
+    std::vector<int>    viActive;
+
+    vbActive.assign (vpsExpanded.size (), false);
+
+    for (int i = 0; i != vpsExpanded.size (); ++i)
+    {
+        if (vpsExpanded[i]->uQuality)
+        {
+            viActive.push_back (i);
+            vbActive[i] = true;
+        }
+    }
+
+    if (viActive.size () < minConcurrentPaths)
+        return false;
+
+    BOOST_FOREACH (int i, viActive)
+    {
+        vpsExpanded[i]->saInAct     = saInAct;
+        vpsExpanded[i]->saOutAct    = saOutAct;
+    }
+
+    // Multiple qualities are only computed for the last path, when every path
+    // before it ran dry in the same pass.
+    pspLast.reset ();
+
+    if (viActive.size () == vpsExpanded.size ())
+        pspLast = boost::make_shared<PathState> (*vpsExpanded.back ());
+
+    vlesNext.clear ();
+    vlesNext.resize (vpsExpanded.size ());
+    vusUnfunded.clear ();
+    vusUnfunded.resize (vpsExpanded.size ());
+
+    std::vector<std::exception_ptr> errors (viActive.size ());
+
+    boost::shared_ptr<PathsNextWork> work (boost::make_shared<PathsNextWork> (viActive.size (),
+        [&] (std::size_t i)
+        {
+            int const   iPath   = viActive[i];
+
+            try
+            {
+                RippleCalc  rcPath (vlesNext[iPath], mOpenLedger);
+
+                rcPath.mumSource        = mumSource;
+                rcPath.musUnfundedFound = musUnfundedFound;
+
+                rcPath.pathNext (vpsExpanded[iPath], false, lesCheckpoint, vlesNext[iPath]);
+
+                vusUnfunded[iPath].swap (rcPath.musUnfundedFound);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception ();
+            }
+        }));
+
+    std::size_t const   helpers = std::min (maxHelpers, viActive.size () - 1);
+
+    for (std::size_t i = 0; i < helpers; ++i)
+    {
+        getApp().getJobQueue ().addJob (jtPATH_CALC, "RippleCalc::pathsNext",
+            [work] (Job&)
+            {
+                work->run ();
+            });
+    }
+
+    work->run ();
+    work->wait ();
+
+    BOOST_FOREACH (std::exception_ptr const & error, errors)
+    {
+        if (error)
+            std::rethrow_exception (error);
+    }
+
+    return true;
+}
+
 // <-- TER: Only returns tepPATH_PARTIAL if !bPartialPayment.
 TER RippleCalc::rippleCalc (
     // Compute paths vs this ledger entry set.  Up to caller to actually apply to ledger.
@@ -2132,10 +2284,21 @@ TER RippleCalc::rippleCalc (
         int                     iDry            = 0;
         bool                    bMultiQuality   = false;                    // True, if ever computed multi-quality.
 
+        // When path finding, compute the increments of the active paths concurrently.
+        // Applying transactions stays serial.
+        std::vector<LedgerEntrySet>                     vlesNext;
+        std::vector< boost::unordered_set<uint256> >    vusUnfunded;
+        std::vector<bool>                               vbActive;
+        PathState::pointer                              pspLast;
+        const bool              bConcurrent     = bStandAlone
+            && rc.pathsNext (vpsExpanded, saMaxAmountAct, saDstAmountAct, lesCheckpoint, vlesNext, vusUnfunded, vbActive, pspLast);
+
         // Find the best path.
         BOOST_FOREACH (PathState::ref pspCur, vpsExpanded)
         {
-            if (pspCur->uQuality)                                           // Only do active paths.
+            // Only do active paths. Paths which ran dry computing their increments concurrently
+            // were active too, and count as dry below.
+            if (bConcurrent ? vbActive[pspCur->getIndex ()] : !!pspCur->uQuality)
             {
                 bMultiQuality       = 1 == vpsExpanded.size () - iDry,      // Computing the only non-dry path, compute multi-quality.
 
@@ -2156,7 +2319,25 @@ TER RippleCalc::rippleCalc (
 
                 assert (pspCur->saOutAct < pspCur->saOutReq);                               // Error if done, output met.
 
-                rc.pathNext (pspCur, bMultiQuality, lesCheckpoint, lesActive);  // Compute increment.
+                if (!bConcurrent)
+                {
+                    rc.pathNext (pspCur, bMultiQuality, lesCheckpoint, lesActive);  // Compute increment.
+                }
+                else if (bMultiQuality)
+                {
+                    // Only the last path is left: recompute it from its state before the pass.
+                    assert (pspLast && pspCur == vpsExpanded.back ());
+
+                    vpsExpanded.back () = pspLast;                          // pspCur refers to this slot.
+                    rc.pathNext (pspCur, bMultiQuality, lesCheckpoint, lesActive);
+                }
+                else
+                {
+                    // Use the increment already computed.
+                    lesActive.swapWith (vlesNext[pspCur->getIndex ()]);
+                    rc.musUnfundedFound.insert (vusUnfunded[pspCur->getIndex ()].begin (), vusUnfunded[pspCur->getIndex ()].end ());
+                }
+
                 WriteLog (lsDEBUG, RippleCalc) << boost::str (boost::format ("rippleCalc: AFTER: mIndex=%d uQuality=%d rate=%s")
                                                % pspCur->mIndex
                                                % pspCur->uQuality
@@ -39,6 +39,10 @@ public:
     boost::unordered_set<uint256>   musUnfundedFound;   // Offers that were found unfunded.
 
     void                pathNext (PathState::ref psrCur, const bool bMultiQuality, const LedgerEntrySet& lesCheckpoint, LedgerEntrySet& lesCurrent);
+    bool                pathsNext (std::vector<PathState::pointer>& vpsExpanded, const STAmount& saInAct, const STAmount& saOutAct,
+                                   const LedgerEntrySet& lesCheckpoint, std::vector<LedgerEntrySet>& vlesNext,
+                                   std::vector< boost::unordered_set<uint256> >& vusUnfunded, std::vector<bool>& vbActive,
+                                   PathState::pointer& pspLast);
     TER                 calcNode (const unsigned int uNode, PathState& psCur, const bool bMultiQuality);
     TER                 calcNodeRev (const unsigned int uNode, PathState& psCur, const bool bMultiQuality);
     TER                 calcNodeFwd (const unsigned int uNode, PathState& psCur, const bool bMultiQuality);
@@ -19,9 +19,11 @@
 
 namespace ripple {
 
-RippleLineCache::RippleLineCache (Ledger::ref l)
+RippleLineCache::RippleLineCache (Ledger::ref l, TrustLineGraph::pointer const& graph)
     : mLedger (l)
+    , mGraph (graph)
 {
+    assert (!mGraph || (mGraph->getLedgerSeq () == mLedger->getLedgerSeq ()));
 }
 
 AccountItems& RippleLineCache::getRippleLines (const uint160& accountID)
@@ -37,4 +39,27 @@ AccountItems& RippleLineCache::getRippleLines (const uint160& accountID)
     return *it->second;
 }
 
+TrustLineGraph::Lines RippleLineCache::getLines (const uint160& accountID)
+{
+    if (mGraph)
+        return mGraph->getLines (accountID);
+
+    {
+        ScopedLockType sl (mLock);
+
+        ripple::unordered_map <uint160, TrustLineGraph::pointer>::iterator it = mGraphMap.find (accountID);
+
+        if (it != mGraphMap.end ())
+            return it->second->getLines (accountID);
+    }
+
+    // Read the lines without holding the lock. If another thread got there
+    // first, its graph is kept.
+    TrustLineGraph::pointer graph (TrustLineGraph::buildAccount (mLedger, accountID));
+
+    ScopedLockType sl (mLock);
+
+    return mGraphMap.insert (std::make_pair (accountID, graph)).first->second->getLines (accountID);
+}
+
 } // ripple
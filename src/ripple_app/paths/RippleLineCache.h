@@ -29,7 +29,13 @@ public:
     typedef boost::shared_ptr <RippleLineCache> pointer;
     typedef pointer const& ref;
 
-    explicit RippleLineCache (Ledger::ref l);
+    /** Create the cache.
+        If a graph of the trust lines of the ledger is given, lines are
+        looked up in it. Otherwise the lines of each account are read from
+        the ledger the first time they are asked for.
+    */
+    explicit RippleLineCache (Ledger::ref l,
+        TrustLineGraph::pointer const& graph = TrustLineGraph::pointer ());
 
     Ledger::ref getLedger () // VFALCO TODO const?
     {
@@ -38,14 +44,18 @@ public:
 
     AccountItems& getRippleLines (const uint160& accountID);
 
+    TrustLineGraph::Lines getLines (const uint160& accountID);
+
 private:
     typedef RippleMutex LockType;
     typedef std::lock_guard <LockType> ScopedLockType;
     LockType mLock;
    
     Ledger::pointer mLedger;
+    TrustLineGraph::pointer mGraph;
     
     ripple::unordered_map <uint160, AccountItems::pointer> mRLMap;
+    ripple::unordered_map <uint160, TrustLineGraph::pointer> mGraphMap;
 };
 
 } // ripple
@@ -0,0 +1,360 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+namespace ripple {
+
+// Collects the lines of a graph before they are laid out by account
+class TrustLineGraph::Builder
+{
+public:
+    explicit Builder (TrustLineGraph& graph)
+        : m_graph (graph)
+    {
+    }
+
+    // Returns true if the state tree item is a trust line, without parsing it.
+    // The entry type is always the first field of a ledger entry.
+    static bool isRippleState (SHAMapItem::ref item)
+    {
+        Blob const& data (item->peekData ());
+
+        return (data.size () >= 3) && (data [0] == 0x11)
+            && (((data [1] << 8) | data [2]) == ltRIPPLE_STATE);
+    }
+
+    // Adds the line, as seen from both of its accounts
+    void add (SLE const& sle)
+    {
+        add (sle, false);
+        add (sle, true);
+    }
+
+    // Adds the line, as seen from the low or the high account
+    void add (SLE const& sle, bool high)
+    {
+        STAmount const& lowLimit (sle.getFieldAmount (sfLowLimit));
+        STAmount const& highLimit (sle.getFieldAmount (sfHighLimit));
+        STAmount const& balance (sle.getFieldAmount (sfBalance));
+        std::uint32_t const flags (sle.getFieldU32 (sfFlags));
+
+        Edge edge;
+        Line& line (edge.line);
+
+        edge.account = account (high ? highLimit.getIssuer () : lowLimit.getIssuer ());
+        line.peer = account (high ? lowLimit.getIssuer () : highLimit.getIssuer ());
+        line.currency = currency (balance.getCurrency ());
+
+        line.balance = balance.getMantissa ();
+        line.balanceExponent = static_cast <std::int8_t> (balance.getExponent ());
+        line.limit = (high ? highLimit : lowLimit).getMantissa ();
+        line.limitExponent = static_cast <std::int8_t> ((high ? highLimit : lowLimit).getExponent ());
+        line.limitPeer = (high ? lowLimit : highLimit).getMantissa ();
+        line.limitPeerExponent = static_cast <std::int8_t> ((high ? lowLimit : highLimit).getExponent ());
+
+        line.qualityIn = sle.getFieldU32 (high ? sfHighQualityIn : sfLowQualityIn);
+        line.qualityOut = sle.getFieldU32 (high ? sfHighQualityOut : sfLowQualityOut);
+
+        // The balance is held from the point of view of the low account
+        line.flags = 0;
+        if (balance.signum () != 0 && ((balance.signum () < 0) != high))
+            line.flags |= lineNegative;
+        if (is_bit_set (flags, high ? lsfHighAuth : lsfLowAuth))
+            line.flags |= lineAuth;
+        if (is_bit_set (flags, high ? lsfLowAuth : lsfHighAuth))
+            line.flags |= lineAuthPeer;
+        if (is_bit_set (flags, high ? lsfHighNoRipple : lsfLowNoRipple))
+            line.flags |= lineNoRipple;
+        if (is_bit_set (flags, high ? lsfLowNoRipple : lsfHighNoRipple))
+            line.flags |= lineNoRipplePeer;
+
+        m_edges.push_back (edge);
+    }
+
+    // Remembers that the line is gone from the previous graph
+    void remove (SLE const& sle)
+    {
+        std::uint32_t const low (account (sle.getFieldAmount (sfLowLimit).getIssuer ()));
+        std::uint32_t const high (account (sle.getFieldAmount (sfHighLimit).getIssuer ()));
+        std::uint32_t const cur (currency (sle.getFieldAmount (sfBalance).getCurrency ()));
+
+        m_removed.insert (key (low, high, cur));
+        m_removed.insert (key (high, low, cur));
+
+        touch (low);
+        touch (high);
+    }
+
+    // Lays out the lines by account, after those kept from the previous graph
+    void finish (TrustLineGraph const* previous)
+    {
+        std::size_t const accountCount (m_graph.m_accounts.size ());
+
+        std::stable_sort (m_edges.begin (), m_edges.end (),
+            [] (Edge const& lhs, Edge const& rhs)
+            {
+                return lhs.account < rhs.account;
+            });
+
+        m_touched.resize (accountCount, false);
+        m_graph.m_offsets.reserve (accountCount + 1);
+        m_graph.m_lines.reserve (m_edges.size () +
+            ((previous != nullptr) ? previous->m_lines.size () : 0));
+
+        std::vector <Edge>::const_iterator edge (m_edges.begin ());
+
+        for (std::uint32_t i = 0; i < accountCount; ++i)
+        {
+            m_graph.m_offsets.push_back (m_graph.m_lines.size ());
+
+            if ((previous != nullptr) && (i < previous->m_accounts.size ()))
+            {
+                std::vector <Line>::const_iterator iter (
+                    previous->m_lines.begin () + previous->m_offsets [i]);
+                std::vector <Line>::const_iterator const end (
+                    previous->m_lines.begin () + previous->m_offsets [i + 1]);
+
+                for (; iter != end; ++iter)
+                {
+                    if (! m_touched [i] || (m_removed.find (
+                            key (i, iter->peer, iter->currency)) == m_removed.end ()))
+                        m_graph.m_lines.push_back (*iter);
+                }
+            }
+
+            for (; (edge != m_edges.end ()) && (edge->account == i); ++edge)
+                m_graph.m_lines.push_back (edge->line);
+        }
+
+        m_graph.m_offsets.push_back (m_graph.m_lines.size ());
+    }
+
+private:
+    struct Edge
+    {
+        std::uint32_t account;
+        Line line;
+    };
+
+    typedef std::pair <std::uint64_t, std::uint32_t> key_type;
+
+    static key_type key (std::uint32_t account, std::uint32_t peer, std::uint32_t currency)
+    {
+        return key_type ((std::uint64_t (account) << 32) | peer, currency);
+    }
+
+    std::uint32_t account (uint160 const& accountID)
+    {
+        return intern (accountID, m_graph.m_accounts, m_graph.m_accountIndex);
+    }
+
+    std::uint32_t currency (uint160 const& currencyID)
+    {
+        return intern (currencyID, m_graph.m_currencies, m_graph.m_currencyIndex);
+    }
+
+    static std::uint32_t intern (uint160 const& id,
+        std::vector <uint160>& ids, index_map& index)
+    {
+        std::pair <index_map::iterator, bool> const result (
+            index.emplace (id, static_cast <std::uint32_t> (ids.size ())));
+
+        if (result.second)
+            ids.push_back (id);
+
+        return result.first->second;
+    }
+
+    void touch (std::uint32_t account)
+    {
+        if (account >= m_touched.size ())
+            m_touched.resize (account + 1, false);
+
+        m_touched [account] = true;
+    }
+
+    TrustLineGraph& m_graph;
+    std::vector <Edge> m_edges;
+    boost::unordered_set <key_type> m_removed;
+    std::vector <bool> m_touched;
+};
+
+//------------------------------------------------------------------------------
+
+TrustLineGraph::TrustLineGraph (std::uint32_t ledgerSeq)
+    : m_ledgerSeq (ledgerSeq)
+    , m_incremental (false)
+    , m_changed (0)
+    , m_buildMilliseconds (0)
+{
+}
+
+TrustLineGraph::pointer TrustLineGraph::build (Ledger::ref ledger, pointer const& previous)
+{
+    return build (ledger->getLedgerSeq (), ledger->peekAccountStateMap (), previous);
+}
+
+TrustLineGraph::pointer TrustLineGraph::build (std::uint32_t ledgerSeq,
+    SHAMap::pointer const& stateMap, pointer const& previous)
+{
+    // Past this many changed entries, reading the whole tree is cheaper
+    int const maxChanges = 100000;
+
+    std::chrono::steady_clock::time_point const start (
+        std::chrono::steady_clock::now ());
+
+    boost::shared_ptr <TrustLineGraph> graph (
+        new TrustLineGraph (ledgerSeq));
+    Builder builder (*graph);
+    SHAMap::Delta changes;
+
+    graph->m_stateMap = stateMap;
+
+    if (previous && previous->m_stateMap
+        && (previous->m_ledgerSeq < ledgerSeq)
+        && graph->m_stateMap->compare (previous->m_stateMap, changes, maxChanges))
+    {
+        // New accounts and currencies are appended, so the indexes of the
+        // previous graph remain valid and its lines can be copied as is.
+        graph->m_accounts = previous->m_accounts;
+        graph->m_currencies = previous->m_currencies;
+        graph->m_accountIndex = previous->m_accountIndex;
+        graph->m_currencyIndex = previous->m_currencyIndex;
+
+        BOOST_FOREACH (SHAMap::Delta::value_type const& change, changes)
+        {
+            SHAMapItem::ref before (change.second.second);
+            SHAMapItem::ref after (change.second.first);
+
+            if (before && Builder::isRippleState (before))
+            {
+                builder.remove (SLE (before->peekSerializer (), before->getTag ()));
+                ++graph->m_changed;
+            }
+
+            if (after && Builder::isRippleState (after))
+            {
+                builder.add (SLE (after->peekSerializer (), after->getTag ()));
+                ++graph->m_changed;
+            }
+        }
+
+        builder.finish (previous.get ());
+        graph->m_incremental = true;
+    }
+    else
+    {
+        graph->m_stateMap->visitLeaves ([&builder] (SHAMapItem::ref item)
+        {
+            if (Builder::isRippleState (item))
+                builder.add (SLE (item->peekSerializer (), item->getTag ()));
+        });
+
+        builder.finish (nullptr);
+        graph->m_changed = graph->m_lines.size () / 2;
+    }
+
+    graph->m_buildMilliseconds = static_cast <int> (
+        std::chrono::duration_cast <std::chrono::milliseconds> (
+            std::chrono::steady_clock::now () - start).count ());
+
+    return graph;
+}
+
+TrustLineGraph::pointer TrustLineGraph::buildAccount (Ledger::ref ledger, uint160 const& accountID)
+{
+    std::chrono::steady_clock::time_point const start (
+        std::chrono::steady_clock::now ());
+
+    boost::shared_ptr <TrustLineGraph> graph (
+        new TrustLineGraph (ledger->getLedgerSeq ()));
+    Builder builder (*graph);
+
+    uint256 const rootIndex (Ledger::getOwnerDirIndex (accountID));
+    uint256 currentIndex (rootIndex);
+
+    while (SLE::pointer ownerDir = ledger->getDirNode (currentIndex))
+    {
+        BOOST_FOREACH (uint256 const& uNode, ownerDir->getFieldV256 (sfIndexes).peekValue ())
+        {
+            SLE::pointer sleCur (ledger->getSLEi (uNode));
+
+            if (sleCur && (sleCur->getType () == ltRIPPLE_STATE))
+                builder.add (*sleCur,
+                    sleCur->getFieldAmount (sfHighLimit).getIssuer () == accountID);
+        }
+
+        std::uint64_t const uNodeNext (ownerDir->getFieldU64 (sfIndexNext));
+
+        if (!uNodeNext)
+            break;
+
+        currentIndex = Ledger::getDirNodeIndex (rootIndex, uNodeNext);
+    }
+
+    builder.finish (nullptr);
+    graph->m_changed = graph->m_lines.size ();
+
+    graph->m_buildMilliseconds = static_cast <int> (
+        std::chrono::duration_cast <std::chrono::milliseconds> (
+            std::chrono::steady_clock::now () - start).count ());
+
+    return graph;
+}
+
+TrustLineGraph::Lines TrustLineGraph::getLines (uint160 const& accountID) const
+{
+    index_map::const_iterator const iter (m_accountIndex.find (accountID));
+
+    if (iter == m_accountIndex.end ())
+        return Lines ();
+
+    std::uint32_t const i (iter->second);
+
+    return Lines (*this, i, m_lines.data () + m_offsets [i],
+        m_lines.data () + m_offsets [i + 1]);
+}
+
+std::size_t TrustLineGraph::getMemoryUsed () const
+{
+    // Each hash table entry costs the key, the value and about two pointers
+    std::size_t const entrySize (sizeof (uint160) + sizeof (std::uint32_t) + 2 * sizeof (void*));
+
+    return (m_accounts.capacity () + m_currencies.capacity ()) * sizeof (uint160)
+        + (m_accountIndex.size () + m_currencyIndex.size ()) * entrySize
+        + m_offsets.capacity () * sizeof (std::uint32_t)
+        + m_lines.capacity () * sizeof (Line);
+}
+
+Json::Value TrustLineGraph::getJson () const
+{
+    Json::Value ret (Json::objectValue);
+
+    ret["ledger_index"] = m_ledgerSeq;
+    ret["accounts"] = static_cast <Json::UInt> (m_accounts.size ());
+    ret["currencies"] = static_cast <Json::UInt> (m_currencies.size ());
+    ret["lines"] = static_cast <Json::UInt> (m_lines.size ());
+    ret["bytes"] = static_cast <Json::UInt> (getMemoryUsed ());
+    ret["build_ms"] = m_buildMilliseconds;
+    ret["incremental"] = m_incremental;
+    ret["changed"] = static_cast <Json::UInt> (m_changed);
+
+    return ret;
+}
+
+} // ripple
@@ -0,0 +1,267 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_TRUSTLINEGRAPH_H
+#define RIPPLE_TRUSTLINEGRAPH_H
+
+namespace ripple {
+
+/** An immutable snapshot of the trust lines of a ledger, for path finding.
+
+    Every trust line is stored twice, once as seen from each of its
+    accounts. The lines of an account are contiguous and are located through
+    the account's index, in compressed sparse row layout. Accounts and
+    currencies are stored once and referred to by index, and amounts are
+    kept as a bare mantissa and exponent, so that a line costs a few dozen
+    bytes instead of a RippleState and its ledger entry.
+
+    A graph holds either every trust line of a ledger, built from the whole
+    state tree or from the graph of an earlier ledger and the entries that
+    changed since, or just the lines of a single account.
+*/
+class TrustLineGraph : public beast::Uncopyable
+{
+public:
+    typedef boost::shared_ptr <TrustLineGraph const> pointer;
+
+    // A trust line as seen from one of its accounts
+    struct Line
+    {
+        std::uint32_t   peer;               // Index of the other account
+        std::uint32_t   currency;           // Index of the currency
+        std::uint64_t   balance;            // Mantissas
+        std::uint64_t   limit;
+        std::uint64_t   limitPeer;
+        std::uint32_t   qualityIn;
+        std::uint32_t   qualityOut;
+        std::int8_t     balanceExponent;
+        std::int8_t     limitExponent;
+        std::int8_t     limitPeerExponent;
+        std::uint8_t    flags;
+    };
+
+    enum
+    {
+        lineNegative    = 0x01,             // The balance is negative
+        lineAuth        = 0x02,
+        lineAuthPeer    = 0x04,
+        lineNoRipple    = 0x08,
+        lineNoRipplePeer = 0x10
+    };
+
+    // A trust line with the accessors of RippleState
+    class TrustLine
+    {
+    public:
+        TrustLine (TrustLineGraph const& graph, std::uint32_t account, Line const& line)
+            : m_graph (graph)
+            , m_account (account)
+            , m_line (line)
+        {
+        }
+
+        uint160 const& getAccountID () const
+        {
+            return m_graph.m_accounts [m_account];
+        }
+
+        uint160 const& getAccountIDPeer () const
+        {
+            return m_graph.m_accounts [m_line.peer];
+        }
+
+        uint160 const& getCurrency () const
+        {
+            return m_graph.m_currencies [m_line.currency];
+        }
+
+        // The issuer of the balance is not kept.
+        STAmount getBalance () const
+        {
+            return STAmount (getCurrency (), ACCOUNT_ONE, m_line.balance,
+                m_line.balanceExponent, (m_line.flags & lineNegative) != 0);
+        }
+
+        STAmount getLimit () const
+        {
+            return STAmount (getCurrency (), getAccountID (),
+                m_line.limit, m_line.limitExponent);
+        }
+
+        STAmount getLimitPeer () const
+        {
+            return STAmount (getCurrency (), getAccountIDPeer (),
+                m_line.limitPeer, m_line.limitPeerExponent);
+        }
+
+        bool getAuth () const
+        {
+            return (m_line.flags & lineAuth) != 0;
+        }
+
+        bool getAuthPeer () const
+        {
+            return (m_line.flags & lineAuthPeer) != 0;
+        }
+
+        bool getNoRipple () const
+        {
+            return (m_line.flags & lineNoRipple) != 0;
+        }
+
+        bool getNoRipplePeer () const
+        {
+            return (m_line.flags & lineNoRipplePeer) != 0;
+        }
+
+        std::uint32_t getQualityIn () const
+        {
+            return m_line.qualityIn;
+        }
+
+        std::uint32_t getQualityOut () const
+        {
+            return m_line.qualityOut;
+        }
+
+    private:
+        TrustLineGraph const& m_graph;
+        std::uint32_t m_account;
+        Line const& m_line;
+    };
+
+    // The trust lines of one account. Only valid while the graph is.
+    class Lines
+    {
+    public:
+        Lines ()
+            : m_graph (nullptr)
+            , m_account (0)
+            , m_begin (nullptr)
+            , m_end (nullptr)
+        {
+        }
+
+        Lines (TrustLineGraph const& graph, std::uint32_t account,
+                Line const* begin, Line const* end)
+            : m_graph (&graph)
+            , m_account (account)
+            , m_begin (begin)
+            , m_end (end)
+        {
+        }
+
+        std::size_t size () const
+        {
+            return m_end - m_begin;
+        }
+
+        bool empty () const
+        {
+            return m_begin == m_end;
+        }
+
+        TrustLine operator[] (std::size_t i) const
+        {
+            return TrustLine (*m_graph, m_account, m_begin [i]);
+        }
+
+    private:
+        TrustLineGraph const* m_graph;
+        std::uint32_t m_account;
+        Line const* m_begin;
+        Line const* m_end;
+    };
+
+    /** Build the graph of every trust line in a ledger.
+        If a graph of an earlier ledger is given, only the entries that
+        changed since are read, unless there are too many of them.
+        The ledger must be immutable.
+        @throws SHAMapMissingNode if part of the state tree is not available.
+    */
+    static pointer build (Ledger::ref ledger, pointer const& previous);
+
+    /** Build the graph of every trust line in a state tree.
+        The state tree stands for the ledger with the given sequence, and
+        must be immutable.
+    */
+    static pointer build (std::uint32_t ledgerSeq, SHAMap::pointer const& stateMap,
+        pointer const& previous);
+
+    /** Build the graph of the trust lines of a single account.
+        The lines of the other accounts of the graph are not available.
+    */
+    static pointer buildAccount (Ledger::ref ledger, uint160 const& accountID);
+
+    Lines getLines (uint160 const& accountID) const;
+
+    std::uint32_t getLedgerSeq () const
+    {
+        return m_ledgerSeq;
+    }
+
+    // Returns the number of accounts known to the graph
+    std::size_t getAccountCount () const
+    {
+        return m_accounts.size ();
+    }
+
+    // Returns the number of lines, counting each as seen from each account
+    std::size_t getLineCount () const
+    {
+        return m_lines.size ();
+    }
+
+    // Approximate memory used by the graph, in bytes
+    std::size_t getMemoryUsed () const;
+
+    int getBuildMilliseconds () const
+    {
+        return m_buildMilliseconds;
+    }
+
+    /** Returns the size and build statistics of the graph. */
+    Json::Value getJson () const;
+
+private:
+    class Builder;
+
+    explicit TrustLineGraph (std::uint32_t ledgerSeq);
+
+    typedef ripple::unordered_map <uint160, std::uint32_t> index_map;
+
+    std::uint32_t m_ledgerSeq;
+    SHAMap::pointer m_stateMap;             // To compute the changes from
+
+    std::vector <uint160> m_accounts;
+    std::vector <uint160> m_currencies;
+    index_map m_accountIndex;
+    index_map m_currencyIndex;
+
+    std::vector <std::uint32_t> m_offsets;  // Lines of account i are [offsets[i], offsets[i+1])
+    std::vector <Line> m_lines;
+
+    bool m_incremental;
+    std::size_t m_changed;
+    int m_buildMilliseconds;
+};
+
+} // ripple
+
+#endif
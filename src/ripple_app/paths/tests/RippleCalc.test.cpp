@@ -0,0 +1,194 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "../../../beast/beast/unit_test/suite.h"
+
+namespace ripple {
+
+class RippleCalc_test : public beast::unit_test::suite
+{
+public:
+    // Gives the application's job queue threads while in scope, then puts
+    // back the number it had, so other tests see the queue unchanged.
+    class ScopedJobQueueThreads
+    {
+    public:
+        ScopedJobQueueThreads (JobQueue& jobQueue, int threadCount)
+            : m_jobQueue (jobQueue)
+            , m_previous (jobQueue.getThreadCount ())
+        {
+            m_jobQueue.setThreadCount (threadCount, false);
+        }
+
+        ~ScopedJobQueueThreads ()
+        {
+            // Setting zero threads picks a count instead, but shutting the
+            // queue down only pauses its threads, after any running job.
+            if (m_previous == 0)
+                m_jobQueue.shutdown ();
+            else
+                m_jobQueue.setThreadCount (m_previous, false);
+        }
+
+    private:
+        JobQueue& m_jobQueue;
+        int const m_previous;
+    };
+
+    // Creates an account with no flags
+    static void createAccount (LedgerEntrySet& les, uint160 const& accountID)
+    {
+        SLE::pointer const sle (les.entryCreate (ltACCOUNT_ROOT,
+            Ledger::getAccountRootIndex (accountID)));
+
+        sle->setFieldAccount (sfAccount, accountID);
+        sle->setFieldAmount (sfBalance, STAmount (SYSTEM_CURRENCY_PARTS * 1000));
+    }
+
+    // Creates a line on which holder trusts issuer for limit
+    static void createLine (LedgerEntrySet& les, uint160 const& holder,
+        uint160 const& issuer, uint160 const& currency, int limit)
+    {
+        bool const bHolderHigh (holder > issuer);
+        uint160 const& low (bHolderHigh ? issuer : holder);
+        uint160 const& high (bHolderHigh ? holder : issuer);
+
+        SLE::pointer const sle (les.entryCreate (ltRIPPLE_STATE,
+            Ledger::getRippleStateIndex (low, high, currency)));
+
+        sle->setFieldAmount (sfBalance, STAmount (currency, ACCOUNT_ONE, 0));
+        sle->setFieldAmount (sfLowLimit, STAmount (currency, low, bHolderHigh ? 0 : limit));
+        sle->setFieldAmount (sfHighLimit, STAmount (currency, high, bHolderHigh ? limit : 0));
+    }
+
+    // Returns every entry of a set with its action, in index order
+    static std::vector <std::string> describe (LedgerEntrySet const& les)
+    {
+        std::vector <std::string> result;
+
+        for (LedgerEntrySet::const_iterator it = les.begin (); it != les.end (); ++it)
+        {
+            result.push_back (boost::str (boost::format ("%s %d %s")
+                % it->first.GetHex ()
+                % it->second.mAction
+                % it->second.mEntry->getJson (0).toStyledString ()));
+        }
+
+        return result;
+    }
+
+    // Four paths share the line into the destination from gA, and one more goes
+    // through gB. The first pass takes the gA line, so on the second pass the
+    // four gA paths run dry and the gB path is the only one left: it must be
+    // computed with multiple qualities, the way a serial pass computes it.
+    void testDryPaths ()
+    {
+        testcase ("dry paths");
+
+        RippleAddress const seed (RippleAddress::createSeedGeneric ("masterpassphrase"));
+        RippleAddress const master (RippleAddress::createAccountPublic (
+            RippleAddress::createGeneratorPublic (seed), 0));
+
+        Ledger::pointer const ledger (boost::make_shared <Ledger> (master, SYSTEM_CURRENCY_START));
+        LedgerEntrySet les (ledger, tapNONE);
+
+        uint160 usd;
+        STAmount::currencyFromString (usd, "USD");
+
+        uint160 const src (101);
+        uint160 const dst (102);
+        uint160 const gA (103);
+        uint160 const gB (104);
+        uint160 const hops [] = { uint160 (105), uint160 (106), uint160 (107), uint160 (108) };
+
+        createAccount (les, src);
+        createAccount (les, dst);
+        createAccount (les, gA);
+        createAccount (les, gB);
+
+        STPathSet paths;
+
+        BOOST_FOREACH (uint160 const& hop, hops)
+        {
+            createAccount (les, hop);
+            createLine (les, hop, src, usd, 100);
+            createLine (les, gA, hop, usd, 100);
+
+            STPath path;
+            path.addElement (STPathElement (STPathElement::typeAccount, hop, usd, hop));
+            path.addElement (STPathElement (STPathElement::typeAccount, gA, usd, gA));
+            paths.addPath (path);
+        }
+
+        createLine (les, dst, gA, usd, 30);
+        createLine (les, gB, src, usd, 100);
+        createLine (les, dst, gB, usd, 20);
+
+        {
+            STPath path;
+            path.addElement (STPathElement (STPathElement::typeAccount, gB, usd, gB));
+            paths.addPath (path);
+        }
+
+        STAmount const saMaxAmountReq (usd, src, 100);
+        STAmount const saDstAmountReq (usd, dst, 100);
+
+        LedgerEntrySet lesSerial (les.duplicate ());
+        STAmount saSerialIn;
+        STAmount saSerialOut;
+        std::vector <PathState::pointer> vpsSerial;
+        TER const terSerial (RippleCalc::rippleCalc (lesSerial, saSerialIn, saSerialOut,
+            vpsSerial, saMaxAmountReq, saDstAmountReq, dst, src, paths,
+            true, false, true, false, false));
+
+        LedgerEntrySet lesConcurrent (les.duplicate ());
+        STAmount saConcurrentIn;
+        STAmount saConcurrentOut;
+        std::vector <PathState::pointer> vpsConcurrent;
+        TER terConcurrent;
+
+        {
+            // A stand-alone calculation queues jobs to help it, which
+            // only run if the job queue has threads.
+            ScopedJobQueueThreads threads (getApp().getJobQueue (), 2);
+
+            terConcurrent = RippleCalc::rippleCalc (lesConcurrent, saConcurrentIn,
+                saConcurrentOut, vpsConcurrent, saMaxAmountReq, saDstAmountReq,
+                dst, src, paths, true, false, true, true, false);
+        }
+
+        expect (vpsSerial.size () == 5, "Five paths");
+        expect (terSerial == tesSUCCESS, "Partial payment");
+        expect (saSerialOut.getText () == "50", "Both destination lines are used");
+
+        expect (terConcurrent == terSerial, "Same result");
+        expect (saConcurrentIn == saSerialIn, "Same amount in");
+        expect (saConcurrentOut == saSerialOut, "Same amount out");
+        expect (describe (lesConcurrent) == describe (lesSerial), "Same ledger entries");
+    }
+
+    void run ()
+    {
+        testDryPaths ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(RippleCalc,ripple_app,ripple);
+
+} // ripple
@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "../../../ripple/common/seconds_clock.h"
+
+#include "../../../beast/beast/unit_test/suite.h"
+
+namespace ripple {
+
+class TrustLineGraph_test : public beast::unit_test::suite
+{
+public:
+    // Sets a trust line in the state tree, replacing it if it exists
+    static void setLine (SHAMap& map, uint160 const& low, uint160 const& high,
+        uint160 const& currency, int balance, std::uint32_t flags,
+        std::uint32_t highQualityIn = 0)
+    {
+        SLE sle (ltRIPPLE_STATE, Ledger::getRippleStateIndex (low, high, currency));
+
+        sle.setFieldAmount (sfBalance, STAmount (currency, ACCOUNT_ONE, balance));
+        sle.setFieldAmount (sfLowLimit, STAmount (currency, low, 100));
+        sle.setFieldAmount (sfHighLimit, STAmount (currency, high, 200));
+        sle.setFieldU32 (sfFlags, flags);
+
+        if (highQualityIn != 0)
+            sle.setFieldU32 (sfHighQualityIn, highQualityIn);
+
+        Serializer s;
+        sle.add (s);
+
+        SHAMapItem::pointer item (boost::make_shared <SHAMapItem> (sle.getIndex (), s));
+
+        if (map.hasItem (sle.getIndex ()))
+            map.updateGiveItem (item, false, false);
+        else
+            map.addGiveItem (item, false, false);
+    }
+
+    // Returns the lines of an account in a form that compares regardless of order
+    static std::vector <std::string> describe (TrustLineGraph const& graph,
+        uint160 const& accountID)
+    {
+        std::vector <std::string> result;
+        TrustLineGraph::Lines const lines (graph.getLines (accountID));
+
+        for (std::size_t i = 0; i < lines.size (); ++i)
+        {
+            TrustLineGraph::TrustLine const line (lines [i]);
+
+            result.push_back (boost::str (boost::format ("%s %s %s %s %s %d%d%d%d %u %u")
+                % line.getAccountIDPeer ()
+                % line.getCurrency ()
+                % line.getBalance ().getText ()
+                % line.getLimit ().getFullText ()
+                % line.getLimitPeer ().getFullText ()
+                % line.getAuth () % line.getAuthPeer ()
+                % line.getNoRipple () % line.getNoRipplePeer ()
+                % line.getQualityIn () % line.getQualityOut ()));
+        }
+
+        std::sort (result.begin (), result.end ());
+        return result;
+    }
+
+    void testSides ()
+    {
+        testcase ("sides");
+
+        FullBelowCache fullBelowCache ("test.full_below", get_seconds_clock ());
+        SHAMap map (smtSTATE, fullBelowCache);
+
+        uint160 const low (11);
+        uint160 const high (12);
+        uint160 usd;
+        STAmount::currencyFromString (usd, "USD");
+
+        setLine (map, low, high, usd, 10, lsfLowAuth | lsfHighNoRipple, 7);
+
+        TrustLineGraph::pointer const graph (
+            TrustLineGraph::build (1, map.snapShot (false), TrustLineGraph::pointer ()));
+
+        expect (graph->getLineCount () == 2, "Each line is seen from both accounts");
+
+        TrustLineGraph::Lines const lowLines (graph->getLines (low));
+        TrustLineGraph::Lines const highLines (graph->getLines (high));
+
+        if (! expect (lowLines.size () == 1 && highLines.size () == 1, "One line each"))
+            return;
+
+        TrustLineGraph::TrustLine const fromLow (lowLines [0]);
+        TrustLineGraph::TrustLine const fromHigh (highLines [0]);
+
+        expect (fromLow.getAccountIDPeer () == high, "Low peer");
+        expect (fromLow.getBalance ().getText () == "10", "Low balance");
+        expect (fromLow.getLimit ().getText () == "100", "Low limit");
+        expect (fromLow.getLimitPeer ().getText () == "200", "Low peer limit");
+        expect (fromLow.getAuth () && ! fromLow.getAuthPeer (), "Low auth");
+        expect (! fromLow.getNoRipple () && fromLow.getNoRipplePeer (), "Low no ripple");
+        expect (fromLow.getQualityIn () == 0, "Low quality in");
+
+        expect (fromHigh.getAccountIDPeer () == low, "High peer");
+        expect (fromHigh.getBalance ().getText () == "-10", "High balance");
+        expect (fromHigh.getLimit ().getText () == "200", "High limit");
+        expect (fromHigh.getLimitPeer ().getText () == "100", "High peer limit");
+        expect (! fromHigh.getAuth () && fromHigh.getAuthPeer (), "High auth");
+        expect (fromHigh.getNoRipple () && ! fromHigh.getNoRipplePeer (), "High no ripple");
+        expect (fromHigh.getQualityIn () == 7, "High quality in");
+    }
+
+    void testIncremental ()
+    {
+        testcase ("incremental");
+
+        FullBelowCache fullBelowCache ("test.full_below", get_seconds_clock ());
+        SHAMap map (smtSTATE, fullBelowCache);
+
+        uint160 const a (11);
+        uint160 const b (12);
+        uint160 const c (13);
+        uint160 const d (14);
+        uint160 usd, eur;
+        STAmount::currencyFromString (usd, "USD");
+        STAmount::currencyFromString (eur, "EUR");
+
+        setLine (map, a, b, usd, 10, lsfLowAuth | lsfHighNoRipple, 7);
+        setLine (map, a, c, usd, -5, 0);
+        setLine (map, b, c, usd, 0, lsfHighAuth);
+
+        TrustLineGraph::pointer const first (
+            TrustLineGraph::build (1, map.snapShot (false), TrustLineGraph::pointer ()));
+
+        // Modify a line, flipping its balance and flags, remove one,
+        // and add lines with a new account and a new currency
+        setLine (map, a, b, usd, -3, lsfHighAuth | lsfLowNoRipple);
+        map.delItem (Ledger::getRippleStateIndex (a, c, usd));
+        setLine (map, c, d, usd, 4, lsfLowNoRipple);
+        setLine (map, a, b, eur, 2, 0, 9);
+
+        SHAMap::pointer const snapshot (map.snapShot (false));
+
+        TrustLineGraph::pointer const incremental (
+            TrustLineGraph::build (2, snapshot, first));
+        TrustLineGraph::pointer const full (
+            TrustLineGraph::build (2, snapshot, TrustLineGraph::pointer ()));
+
+        expect (incremental->getJson ()["incremental"].asBool (), "Built from the changes");
+        expect (! full->getJson ()["incremental"].asBool (), "Built from the tree");
+        expect (incremental->getLineCount () == full->getLineCount (), "Same line count");
+        expect (full->getLineCount () == 8, "Four lines from both sides");
+
+        uint160 const accounts [] = { a, b, c, d };
+
+        BOOST_FOREACH (uint160 const& account, accounts)
+        {
+            expect (describe (*incremental, account) == describe (*full, account),
+                "Same lines for " + account.GetHex ());
+        }
+
+        // The removed line is gone from both sides
+        expect (describe (*incremental, c).size () == 2, "c keeps two lines");
+        expect (describe (*incremental, a).size () == 2, "a keeps two lines");
+    }
+
+    void run ()
+    {
+        testSides ();
+        testIncremental ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TrustLineGraph,ripple_app,ripple);
+
+} // ripple
@@ -59,6 +59,7 @@
 // reorder the include lines until the order is correct.
 
 #include "../../ripple/common/KeyCache.h"
+#include "../../ripple/common/SweepCursor.h"
 #include "../../ripple/common/TaggedCache.h"
 
 #include "data/Database.h"
@@ -78,6 +79,7 @@
 #include "tx/Transaction.h"
 #include "misc/AccountState.h"
 #include "misc/NicknameState.h"
+#include "ledger/LedgerEntryCache.h"
 #include "ledger/Ledger.h"
 #include "ledger/SerializedValidation.h"
 #include "main/LoadManager.h"
@@ -117,6 +119,7 @@
 #include "consensus/LedgerConsensus.h"
 #include "ledger/LedgerTiming.h"
 #include "misc/Offer.h"
+#include "paths/TrustLineGraph.h"
 #include "paths/RippleLineCache.h"
 #include "paths/PathRequest.h"
 #include "paths/PathRequests.h"
@@ -31,3 +31,5 @@
 #include "contracts/Operation.cpp"
 #include "contracts/ScriptData.cpp"
 #include "contracts/Interpreter.cpp"
+
+#include "ledger/tests/LedgerHolder.test.cpp"
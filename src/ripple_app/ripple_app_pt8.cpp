@@ -34,7 +34,10 @@
 #include "paths/PathState.cpp"
 
 #include "main/ParameterTable.cpp"
+#include "paths/TrustLineGraph.cpp"
 #include "paths/RippleLineCache.cpp"
+#include "paths/tests/RippleCalc.test.cpp"
+#include "paths/tests/TrustLineGraph.test.cpp"
 #include "ledger/SerializedValidation.cpp"
 
 #ifdef _MSC_VER
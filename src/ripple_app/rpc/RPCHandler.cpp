@@ -119,13 +119,13 @@ Json::Value RPCHandler::doCommand (const Json::Value& params, int iRole, Resourc
     } commandsA[] =
     {
         // Request-response methods
-        {   "account_info",         &RPCHandler::doAccountInfo,         false,  optCurrent  },
-        {   "account_currencies",   &RPCHandler::doAccountCurrencies,   false,  optCurrent  },
-        {   "account_lines",        &RPCHandler::doAccountLines,        false,  optCurrent  },
-        {   "account_offers",       &RPCHandler::doAccountOffers,       false,  optCurrent  },
+        {   "account_info",         &RPCHandler::doAccountInfo,         false,  optReadCurrent },
+        {   "account_currencies",   &RPCHandler::doAccountCurrencies,   false,  optReadCurrent },
+        {   "account_lines",        &RPCHandler::doAccountLines,        false,  optReadCurrent },
+        {   "account_offers",       &RPCHandler::doAccountOffers,       false,  optReadCurrent },
         {   "account_tx",           &RPCHandler::doAccountTxSwitch,     false,  optNetwork  },
         {   "blacklist",            &RPCHandler::doBlackList,           true,   optNone     },
-        {   "book_offers",          &RPCHandler::doBookOffers,          false,  optCurrent  },
+        {   "book_offers",          &RPCHandler::doBookOffers,          false,  optReadCurrent },
         {   "connect",              &RPCHandler::doConnect,             true,   optNone     },
         {   "consensus_info",       &RPCHandler::doConsensusInfo,       true,   optNone     },
         {   "get_counts",           &RPCHandler::doGetCounts,           true,   optNone     },
@@ -135,15 +135,16 @@ Json::Value RPCHandler::doCommand (const Json::Value& params, int iRole, Resourc
         {   "ledger",               &RPCHandler::doLedger,              false,  optNetwork  },
         {   "ledger_accept",        &RPCHandler::doLedgerAccept,        true,   optCurrent  },
         {   "ledger_cleaner",       &RPCHandler::doLedgerCleaner,       true,   optNetwork  },
-        {   "ledger_closed",        &RPCHandler::doLedgerClosed,        false,  optClosed   },
-        {   "ledger_current",       &RPCHandler::doLedgerCurrent,       false,  optCurrent  },
-        {   "ledger_data",          &RPCHandler::doLedgerData,          false,  optCurrent  },
-        {   "ledger_entry",         &RPCHandler::doLedgerEntry,         false,  optCurrent  },
-        {   "ledger_header",        &RPCHandler::doLedgerHeader,        false,  optCurrent  },
+        {   "ledger_closed",        &RPCHandler::doLedgerClosed,        false,  optReadClosed },
+        {   "ledger_current",       &RPCHandler::doLedgerCurrent,       false,  optReadCurrent },
+        {   "ledger_data",          &RPCHandler::doLedgerData,          false,  optReadCurrent },
+        {   "ledger_entry",         &RPCHandler::doLedgerEntry,         false,  optReadCurrent },
+        {   "ledger_header",        &RPCHandler::doLedgerHeader,        false,  optReadCurrent },
+        {   "ledger_proof",         &RPCHandler::doLedgerProof,         false,  optReadCurrent },
         {   "log_level",            &RPCHandler::doLogLevel,            true,   optNone     },
         {   "logrotate",            &RPCHandler::doLogRotate,           true,   optNone     },
 //      {   "nickname_info",        &RPCHandler::doNicknameInfo,        false,  optCurrent  },
-        {   "owner_info",           &RPCHandler::doOwnerInfo,           false,  optCurrent  },
+        {   "owner_info",           &RPCHandler::doOwnerInfo,           false,  optReadCurrent },
         {   "peers",                &RPCHandler::doPeers,               true,   optNone     },
         {   "path_find",            &RPCHandler::doPathFind,            false,  optCurrent  },
         {   "ping",                 &RPCHandler::doPing,                false,  optNone     },
@@ -156,11 +157,12 @@ Json::Value RPCHandler::doCommand (const Json::Value& params, int iRole, Resourc
         {   "ripple_path_find",     &RPCHandler::doRipplePathFind,      false,  optCurrent  },
         {   "sign",                 &RPCHandler::doSign,                false,  optNone     },
         {   "submit",               &RPCHandler::doSubmit,              false,  optCurrent  },
+        {   "submit_benchmark",     &RPCHandler::doSubmitBenchmark,     true,   optCurrent  },
         {   "server_info",          &RPCHandler::doServerInfo,          false,  optNone     },
         {   "server_state",         &RPCHandler::doServerState,         false,  optNone     },
         {   "sms",                  &RPCHandler::doSMS,                 true,   optNone     },
         {   "stop",                 &RPCHandler::doStop,                true,   optNone     },
-        {   "transaction_entry",    &RPCHandler::doTransactionEntry,    false,  optCurrent  },
+        {   "transaction_entry",    &RPCHandler::doTransactionEntry,    false,  optReadCurrent },
         {   "tx",                   &RPCHandler::doTx,                  false,  optNetwork  },
         {   "tx_history",           &RPCHandler::doTxHistory,           false,  optNone     },
         {   "unl_add",              &RPCHandler::doUnlAdd,              true,   optNone     },
@@ -196,7 +198,14 @@ Json::Value RPCHandler::doCommand (const Json::Value& params, int iRole, Resourc
     }
 
     {
-        Application::ScopedLockType lock (getApp().getMasterLock ());
+        Application::ScopedLockType lock (getApp().getMasterLock (), std::defer_lock);
+
+        // Read only commands resolve their ledger through the ledger
+        // holders, which hand out immutable snapshots under their own
+        // brief locks, so they need not wait behind ledger close or
+        // transaction application.
+        if (! (commandsA[i].iOptions & optReadOnly))
+            lock.lock ();
 
         if ((commandsA[i].iOptions & optNetwork) && (mNetOps->getOperatingMode () < NetworkOPs::omSYNCING))
         {
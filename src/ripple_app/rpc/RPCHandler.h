@@ -61,6 +61,12 @@ private:
         optNetwork  = 1,                // Need network
         optCurrent  = 2 + optNetwork,   // Need current ledger
         optClosed   = 4 + optNetwork,   // Need closed ledger
+
+        // Only reads immutable ledger snapshots, so the handler runs
+        // without the master lock and the lock it is given is not held.
+        optReadOnly     = 8,
+        optReadCurrent  = optReadOnly + optCurrent,
+        optReadClosed   = optReadOnly + optClosed,
     };
 
     // Utilities
@@ -88,6 +94,7 @@ private:
     Json::Value doLedgerData            (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doLedgerEntry           (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doLedgerHeader          (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
+    Json::Value doLedgerProof           (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doLogLevel              (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doLogRotate             (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doNicknameInfo          (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
@@ -110,6 +117,7 @@ private:
     Json::Value doSign                  (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doStop                  (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doSubmit                (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
+    Json::Value doSubmitBenchmark       (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doSubscribe             (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doTransactionEntry      (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
     Json::Value doTx                    (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& mlh);
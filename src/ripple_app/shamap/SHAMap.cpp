@@ -72,6 +72,11 @@ TaggedCache <uint256, SHAMapTreeNode>
         get_seconds_clock (),
             LogPartition::getJournal <TaggedCacheLog> ());
 
+TaggedCache <uint256, Blob>
+    SHAMap::proofNodeCache ("ProofNodeCache", 16384, 120,
+        get_seconds_clock (),
+            LogPartition::getJournal <TaggedCacheLog> ());
+
 SHAMap::~SHAMap ()
 {
     mState = smsInvalid;
@@ -98,13 +103,23 @@ void SHAMapNode::setMHash () const
 {
     using namespace std;
 
-    std::size_t h = HashMaps::getInstance ().getNonce <std::size_t> ()
-                    + (mDepth * HashMaps::goldenRatio);
+    static std::size_t const nonce (
+        HashMaps::getInstance ().getNonce <std::size_t> ());
 
-    const unsigned int* ptr = reinterpret_cast <const unsigned int*> (mNodeID.begin ());
+    std::size_t h = nonce + (mDepth * HashMaps::goldenRatio);
 
-    for (int i = (mDepth + 7) / 8; i != 0; --i)
-        h = (h * HashMaps::goldenRatio) ^ *ptr++;
+    // Only the first mDepth nibbles of a node ID can be non-zero,
+    // so hash just that prefix, a machine word at a time. The ID is only
+    // aligned for unsigned int, so each word is copied out.
+    unsigned char const* ptr = mNodeID.begin ();
+
+    for (int i = (mDepth + 2 * sizeof (std::size_t) - 1) / (2 * sizeof (std::size_t)); i != 0; --i)
+    {
+        std::size_t word;
+        memcpy (&word, ptr, sizeof (word));
+        ptr += sizeof (word);
+        h = (h * HashMaps::goldenRatio) ^ word;
+    }
 
     mHash = h;
 }
@@ -1100,11 +1115,19 @@ int SHAMap::armDirty ()
     return ++mSeq;
 }
 
+// Each store may wait briefly when the node store's write batch is full
+// (see BatchWriter::store), but this never waits on its own since the
+// consensus code calls it with the master lock held. Backpressure on a
+// backlogged node store comes instead from the once-per-ledger wait in
+// LedgerConsensus, taken before the master lock.
+//
 int SHAMap::flushDirty (NodeMap& map, int maxNodes, NodeObjectType t, std::uint32_t seq)
 {
     int flushed = 0;
     Serializer s;
 
+    NodeStore::Database& nodeStore (getApp().getNodeStore ());
+
     for (NodeMap::iterator it = map.begin (); it != map.end (); it = map.erase (it))
     {
         //      tLog(t == hotTRANSACTION_NODE, lsDEBUG) << "TX node write " << it->first;
@@ -1124,7 +1147,7 @@ int SHAMap::flushDirty (NodeMap& map, int maxNodes, NodeObjectType t, std::uint3
 
 #endif
 
-        getApp().getNodeStore ().store (t, seq, s.modData (), it->second->getNodeHash ());
+        nodeStore.store (t, seq, s.modData (), it->second->getNodeHash ());
 
         if (flushed++ >= maxNodes)
             return flushed;
@@ -1234,6 +1257,47 @@ bool SHAMap::getPath (uint256 const& index, std::vector< Blob >& nodes, SHANodeF
     return true;
 }
 
+bool SHAMap::getProofPath (uint256 const& index, std::vector<uint256>& path, ProofNodes& nodes)
+{
+    ScopedReadLockType sl (mLock);
+
+    SHAMapTreeNode* inNode = root.get ();
+
+    for (;;)
+    {
+        uint256 const& hash = inNode->getNodeHash ();
+        path.push_back (hash);
+
+        if (nodes.find (hash) == nodes.end ())
+        {
+            // Nodes are immutable once hashed, so any
+            // map's serialization of this hash will do
+            boost::shared_ptr <Blob> data = proofNodeCache.fetch (hash);
+
+            if (!data)
+            {
+                Serializer s;
+                inNode->addRaw (s, snfPREFIX);
+                data = boost::make_shared <Blob> (s.peekData ());
+                proofNodeCache.canonicalize (hash, data);
+            }
+
+            nodes.insert (std::make_pair (hash, data));
+        }
+
+        if (inNode->isLeaf ())
+            return inNode->getTag () == index;
+
+        int branch = inNode->selectBranch (index);
+
+        if (inNode->isEmptyBranch (branch))
+            return false;
+
+        inNode = getNodePointer (inNode->getChildNodeID (branch), inNode->getChildHash (branch));
+        assert (inNode);
+    }
+}
+
 void SHAMap::dropCache ()
 {
     ScopedWriteLockType sl (mLock);
@@ -1388,4 +1452,105 @@ public:
 
 BEAST_DEFINE_TESTSUITE(SHAMap,ripple_app,ripple);
 
+//------------------------------------------------------------------------------
+
+class SHAMapProof_test : public beast::unit_test::suite
+{
+public:
+    static uint256 makeKey (int i)
+    {
+        Serializer s;
+        s.add32 (i);
+        return s.getSHA512Half ();
+    }
+
+    // Checks a proof from the leaf end up to the root: every node must hash
+    // to its entry in the path and be linked from its parent by that hash.
+    void checkProof (uint256 const& rootHash, uint256 const& index, bool present,
+        std::vector<uint256> const& path, SHAMap::ProofNodes const& nodes)
+    {
+        if (!expect (!path.empty () && (path.size () <= 65), "Path length"))
+            return;
+
+        int const last = path.size () - 1;
+
+        for (int depth = last; depth >= 0; --depth)
+        {
+            SHAMap::ProofNodes::const_iterator const it = nodes.find (path[depth]);
+
+            if (!expect (it != nodes.end (), "Node is in the proof"))
+                return;
+
+            SHAMapTreeNode node (SHAMapNode (depth, index), *it->second, 0,
+                snfPREFIX, uint256 (), false);
+
+            expect (node.getNodeHash () == path[depth], "Node hashes to its path entry");
+
+            if (depth == last)
+            {
+                if (node.isLeaf ())
+                    expect ((node.getTag () == index) == present, "Leaf matches the index");
+                else
+                    expect (!present && node.isEmptyBranch (node.selectBranch (index)),
+                        "Missing index ends at an empty branch");
+            }
+            else
+            {
+                expect (node.isInner () &&
+                    (node.getChildHash (node.selectBranch (index)) == path[depth + 1]),
+                    "Parent links to the child");
+            }
+        }
+
+        expect (path[0] == rootHash, "Proof reaches the root");
+    }
+
+    void run ()
+    {
+        testcase ("proof path");
+
+        FullBelowCache fullBelowCache ("test.full_below",
+            get_seconds_clock ());
+
+        SHAMap sMap (smtFREE, fullBelowCache);
+
+        for (int i = 0; i < 256; ++i)
+        {
+            Serializer s;
+            s.add32 (i);
+            sMap.addItem (SHAMapItem (makeKey (i), s.peekData ()), false, false);
+        }
+
+        uint256 const rootHash = sMap.getHash ();
+
+        // An item in the map
+        {
+            uint256 const index (makeKey (17));
+            std::vector<uint256> path;
+            SHAMap::ProofNodes nodes;
+
+            expect (sMap.getProofPath (index, path, nodes), "Item is present");
+            checkProof (rootHash, index, true, path, nodes);
+        }
+
+        // Items not in the map: one whose path ends at a different leaf,
+        // and ones whose path may end at an empty branch
+        uint256 sibling (makeKey (42));
+        *(sibling.end () - 1) ^= 1;
+
+        uint256 const missing [] = { sibling, makeKey (1000), makeKey (1001) };
+
+        BOOST_FOREACH (uint256 const& index, missing)
+        {
+            std::vector<uint256> path;
+            SHAMap::ProofNodes nodes;
+
+            expect (!sMap.getProofPath (index, path, nodes), "Item is missing");
+            checkProof (rootHash, index, false, path, nodes);
+        }
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SHAMapProof,ripple_app,ripple);
+
 } // ripple
@@ -155,6 +155,7 @@ public:
     SHAMapItem::pointer peekNextItem (uint256 const& );
     SHAMapItem::pointer peekNextItem (uint256 const& , SHAMapTreeNode::TNType & type);
     SHAMapItem::pointer peekPrevItem (uint256 const& );
+    // Leaves are visited in key order
     void visitLeaves(std::function<void (SHAMapItem::ref)>);
 
     // comparison/sync functions
@@ -239,6 +240,18 @@ public:
 
     bool getPath (uint256 const & index, std::vector< Blob >& nodes, SHANodeFormat format);
 
+    typedef std::map <uint256, boost::shared_ptr <Blob>> ProofNodes;
+
+    /** Build the proof for an item.
+        The path holds the hash of each node from the root down to the item,
+        or down to the node where the item would be if it is not present.
+        The prefixed serialization of each node is added to the set of
+        nodes, which may be shared by the proofs of several items so that
+        common inner nodes are only included once.
+        @return `true` if the item is present.
+    */
+    bool getProofPath (uint256 const & index, std::vector<uint256>& path, ProofNodes& nodes);
+
     bool deepCompare (SHAMap & other);
 
     virtual void dump (bool withHashes = false);
@@ -260,9 +273,15 @@ public:
         return treeNodeCache.getCacheSize ();
     }
 
+    static int getProofNodeSize ()
+    {
+        return proofNodeCache.getCacheSize ();
+    }
+
     static void sweep ()
     {
         treeNodeCache.sweep ();
+        proofNodeCache.sweep ();
     }
 
     static void setTreeCache (int size, int age)
@@ -271,6 +290,12 @@ public:
         treeNodeCache.setTargetAge (age);
     }
 
+    static void setProofCache (int size, int age)
+    {
+        proofNodeCache.setTargetSize (size);
+        proofNodeCache.setTargetAge (age);
+    }
+
     void setTXMap ()
     {
         mTXMap = true;
@@ -281,6 +306,9 @@ public:
 private:
     static TaggedCache <uint256, SHAMapTreeNode> treeNodeCache;
 
+    // Serialized nodes of recent proofs, by node hash
+    static TaggedCache <uint256, Blob> proofNodeCache;
+
     void dirtyUp (std::stack<SHAMapTreeNode::pointer>& stack, uint256 const & target, uint256 prevHash);
     std::stack<SHAMapTreeNode::pointer> getStack (uint256 const & id, bool include_nonmatching_leaf);
     SHAMapTreeNode::pointer walkTo (uint256 const & id, bool modify);
@@ -314,6 +342,31 @@ private:
 
     void visitLeavesInternal (std::function<void (SHAMapItem::ref item)>& function);
 
+    // What a traversal does after visiting a node
+    enum VisitResult
+    {
+        vrDESCEND,  // Go on to the nodes below it, if any
+        vrSKIP,     // Skip the nodes below it
+        vrSTOP      // End the traversal
+    };
+
+    /** Visit the nodes below an inner node in key order, reading ahead.
+        When the traversal enters an inner node, it requests those of its
+        children that are not in memory from the node store, so they are
+        read in the background while it goes through the children before
+        them. It waits only when it reaches a node still being read. At
+        most readAhead requested nodes are waiting to be reached.
+        @param visit Called for each node, before the nodes below it.
+        @param missing Called for each node not available locally.
+                       Returning `false` ends the traversal.
+        @param release `true` to drop nodes from the map once visited,
+                       when traversing a throwaway snapshot.
+    */
+    void visitNodes (SHAMapTreeNode* node, int readAhead,
+                     std::function<VisitResult (SHAMapTreeNode*)> const& visit,
+                     std::function<bool (SHAMapNode const&, uint256 const&)> const& missing,
+                     bool release);
+
 private:
 
     // This lock protects key SHAMap structures.
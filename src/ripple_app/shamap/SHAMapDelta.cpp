@@ -236,39 +236,22 @@ bool SHAMap::compare (SHAMap::ref otherMap, Delta& differences, int maxCount)
 
 void SHAMap::walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissing)
 {
-    std::stack<SHAMapTreeNode::pointer> nodeStack;
-
     ScopedReadLockType sl (mLock);
 
     if (!root->isInner ())  // root is only node, and we have it
         return;
 
-    nodeStack.push (root);
-
-    while (!nodeStack.empty ())
-    {
-        SHAMapTreeNode::pointer node = nodeStack.top ();
-        nodeStack.pop ();
-
-        for (int i = 0; i < 16; ++i)
-            if (!node->isEmptyBranch (i))
-            {
-                try
-                {
-                    SHAMapTreeNode::pointer d = getNode (node->getChildNodeID (i), node->getChildHash (i), false);
-
-                    if (d->isInner ())
-                        nodeStack.push (d);
-                }
-                catch (SHAMapMissingNode& n)
-                {
-                    missingNodes.push_back (n);
-
-                    if (--maxMissing <= 0)
-                        return;
-                }
-            }
-    }
+    visitNodes (root.get (), getApp().getNodeStore ().getDesiredAsyncReadCount (),
+        [] (SHAMapTreeNode*)
+        {
+            return vrDESCEND;
+        },
+        [&] (SHAMapNode const& nodeID, uint256 const& nodeHash)
+        {
+            missingNodes.push_back (SHAMapMissingNode (mType, nodeID, nodeHash));
+            return --maxMissing > 0;
+        },
+        false);
 }
 
 } // ripple
@@ -19,6 +19,8 @@
 
 #include "../../beast/beast/unit_test/suite.h"
 
+#include <unordered_set>
+
 namespace ripple {
 
 // VFALCO TODO tidy up this global
@@ -45,56 +47,120 @@ void SHAMap::visitLeavesInternal (std::function<void (SHAMapItem::ref item)>& fu
         return;
     }
 
-    typedef std::pair<int, SHAMapTreeNode*> posPair;
+    visitNodes (root.get (), getApp().getNodeStore ().getDesiredAsyncReadCount (),
+        [&function] (SHAMapTreeNode* node)
+        {
+            if (node->isLeaf ())
+                function (node->peekItem ());
+            return vrDESCEND;
+        },
+        [this] (SHAMapNode const& nodeID, uint256 const& nodeHash) -> bool
+        {
+            throw SHAMapMissingNode (mType, nodeID, nodeHash);
+        },
+        true);
+}
 
-    std::stack<posPair> stack;
-    SHAMapTreeNode* node = root.get ();
-    int pos = 0;
+void SHAMap::visitNodes (SHAMapTreeNode* node, int readAhead,
+                         std::function<VisitResult (SHAMapTreeNode*)> const& visit,
+                         std::function<bool (SHAMapNode const&, uint256 const&)> const& missing,
+                         bool release)
+{
+    assert (node->isInner ());
 
-    while (1)
+    std::size_t const maxReads = std::max (readAhead, 1);
+
+    // Nodes requested ahead of the traversal which it has not reached yet
+    std::unordered_set <uint256, beast::hardened_hash <uint256>> reads;
+
+    // Request the children of an inner node which are not in memory
+    auto const readChildren = [&] (SHAMapTreeNode* inner)
     {
-        while (pos < 16)
+        for (int branch = 0; (branch < 16) && (reads.size () < maxReads); ++branch)
         {
-            if (node->isEmptyBranch (pos))
-            {
-                ++pos; // move to next position
-            }
-            else
-            {
-                SHAMapTreeNode* child = getNodePointer (node->getChildNodeID (pos), node->getChildHash (pos));
-                if (child->isLeaf ())
-                {
-                    function (child->peekItem ());
-                    mTNByID.erase (*child); // don't need this leaf anymore
-                    ++pos;
-                }
-                else
-                {
-                    // If there are no more children, don't push this node
-                    while ((pos != 15) && (node->isEmptyBranch (pos + 1)))
-                           ++pos;
-
-                    if (pos != 15)
-                        stack.push (posPair (pos + 1, node)); // save next position to resume at
-                    else
-                        mTNByID.erase (*node); // don't need this inner node anymore
-
-                    // descend to the child's first position
-                    node = child;
-                    pos = 0;
-                }
-            }
+            if (inner->isEmptyBranch (branch))
+                continue;
+
+            bool pending = false;
+            getNodeAsync (inner->getChildNodeID (branch), inner->getChildHash (branch), nullptr, pending);
+
+            if (pending)
+                reads.insert (inner->getChildHash (branch));
         }
+    };
 
-        // We are done with this inner node
-        mTNByID.erase (*node);
+    // Get a node the traversal has reached, waiting for it if it is still being read
+    auto const getChild = [&] (SHAMapNode const& childID, uint256 const& childHash) -> SHAMapTreeNode*
+    {
+        bool pending = false;
+        SHAMapTreeNode* child = getNodeAsync (childID, childHash, nullptr, pending);
 
-        if (stack.empty ())
-            break;
+        if (pending)
+        {
+            getApp().getNodeStore().waitReads();
+            child = getNodeAsync (childID, childHash, nullptr, pending);
+        }
 
-        pos = stack.top ().first;
-        node = stack.top ().second;
-        stack.pop ();
+        reads.erase (childHash);
+
+        // Nodes of transaction maps are never read asynchronously,
+        // and a read can still be outstanding after waiting
+        if (!child)
+            child = getNodePointerNT (childID, childHash);
+
+        return child;
+    };
+
+    // The inner nodes being traversed, with the next branch of each
+    std::stack <std::pair <SHAMapTreeNode*, int>> stack;
+
+    readChildren (node);
+    stack.push (std::make_pair (node, 0));
+
+    while (!stack.empty ())
+    {
+        node = stack.top ().first;
+        int branch = stack.top ().second;
+
+        while ((branch < 16) && node->isEmptyBranch (branch))
+            ++branch;
+
+        if (branch == 16)
+        {
+            stack.pop ();
+
+            if (release)
+                mTNByID.erase (*node);
+
+            continue;
+        }
+
+        stack.top ().second = branch + 1;
+
+        SHAMapNode childID = node->getChildNodeID (branch);
+        uint256 const& childHash = node->getChildHash (branch);
+        SHAMapTreeNode* child = getChild (childID, childHash);
+
+        if (!child)
+        {
+            if (!missing (childID, childHash))
+                return;
+
+            continue;
+        }
+
+        VisitResult const result = visit (child);
+
+        if (result == vrSTOP)
+            return;
+
+        if (child->isInner () && (result == vrDESCEND))
+        {
+            readChildren (child);
+            stack.push (std::make_pair (child, 0));
+        }
+        else if (release)
+            mTNByID.erase (*child);
     }
 }
 
@@ -139,7 +205,7 @@ void SHAMap::getMissingNodes (std::vector<SHAMapNode>& nodeIDs, std::vector<uint
     int const maxDefer = getApp().getNodeStore().getDesiredAsyncReadCount ();
 
     // Track the missing hashes we have found so far
-    std::set <uint256> missingHashes;
+    std::unordered_set <uint256, beast::hardened_hash <uint256>> missingHashes;
 
 
     while (1)
@@ -665,45 +731,37 @@ void SHAMap::getFetchPack (SHAMap* have, bool includeLeaves, int max,
         return;
     }
 
-    std::stack<SHAMapTreeNode*> stack; // contains unexplored non-matching inner node entries
-    stack.push (root.get());
-
-    while (!stack.empty() && (max > 0))
-    {
-        SHAMapTreeNode* node = stack.top ();
-        stack.pop ();
+    // Add the root, then every node below it that we have and they don't
+    Serializer rs;
+    root->addRaw (rs, snfPREFIX);
+    func (boost::cref(root->getNodeHash ()), boost::cref(rs.peekData ()));
 
-        // 1) Add this node to the pack
-        Serializer s;
-        node->addRaw (s, snfPREFIX);
-        func (boost::cref(node->getNodeHash ()), boost::cref(s.peekData ()));
-        --max;
+    if (--max <= 0)
+        return;
 
-        // 2) push non-matching child inner nodes
-        for (int i = 0; i < 16; ++i)
+    visitNodes (root.get (), getApp().getNodeStore ().getDesiredAsyncReadCount (),
+        [&] (SHAMapTreeNode* node) -> VisitResult
         {
-            if (!node->isEmptyBranch (i))
+            if (node->isInner ())
             {
-                uint256 const& childHash = node->getChildHash (i);
-                SHAMapNode childID = node->getChildNodeID (i);
+                if (have && have->hasInnerNode (*node, node->getNodeHash ()))
+                    return vrSKIP;
+            }
+            else if (!includeLeaves || (have && have->hasLeafNode (node->getTag (), node->getNodeHash ())))
+                return vrSKIP;
 
-                SHAMapTreeNode* next = getNodePointer (childID, childHash);
+            Serializer s;
+            node->addRaw (s, snfPREFIX);
+            func (boost::cref(node->getNodeHash ()), boost::cref(s.peekData ()));
 
-                if (next->isInner ())
-                {
-                    if (!have || !have->hasInnerNode (*next, childHash))
-                        stack.push (next);
-                }
-                else if (includeLeaves && (!have || !have->hasLeafNode (next->getTag(), childHash)))
-                {
-                    Serializer s;
-                    next->addRaw (s, snfPREFIX);
-                    func (boost::cref(childHash), boost::cref(s.peekData ()));
-                    --max;
-                }
-            }
-        }
-    }
+            // Stop reading ahead once the pack is full
+            return (--max > 0) ? vrDESCEND : vrSTOP;
+        },
+        [this] (SHAMapNode const& nodeID, uint256 const& nodeHash) -> bool
+        {
+            throw SHAMapMissingNode (mType, nodeID, nodeHash);
+        },
+        false);
 }
 
 std::list<Blob > SHAMap::getTrustedPath (uint256 const& index)
@@ -922,4 +980,131 @@ public:
 
 BEAST_DEFINE_TESTSUITE(SHAMapSync,ripple_app,ripple);
 
+//------------------------------------------------------------------------------
+
+class SHAMapTraverse_test : public beast::unit_test::suite
+{
+public:
+    typedef std::map <uint256, Blob> Nodes;
+
+    // Adds random items to a map, returning their keys in order
+    static std::vector <uint256> fill (SHAMap& map, int count)
+    {
+        std::vector <uint256> keys;
+
+        for (int i = 0; i < count; ++i)
+        {
+            SHAMapItem::pointer item (SHAMapSync_test::makeRandomAS ());
+
+            if (map.addItem (*item, false, false))
+                keys.push_back (item->getTag ());
+        }
+
+        std::sort (keys.begin (), keys.end ());
+        return keys;
+    }
+
+    // Returns the nodes of a map, by hash
+    static Nodes getNodes (SHAMap& map, bool includeLeaves)
+    {
+        Nodes nodes;
+
+        map.getFetchPack (nullptr, includeLeaves, std::numeric_limits <int>::max (),
+            [&nodes] (uint256 const& hash, Blob const& data)
+            {
+                nodes[hash] = data;
+            });
+
+        return nodes;
+    }
+
+    // Makes a map which has only its root in memory, and stores the
+    // given nodes in the node store for it to read the rest
+    static SHAMap::pointer makeUncached (SHAMap& source, Nodes const& stored,
+        FullBelowCache& fullBelowCache)
+    {
+        uint256 const hash (source.getHash ());
+        Nodes const all (getNodes (source, true));
+
+        SHAMap::pointer map (boost::make_shared <SHAMap> (smtFREE, hash, std::ref (fullBelowCache)));
+        map->addRootNode (hash, all.find (hash)->second, snfPREFIX, nullptr);
+        map->clearSynching ();
+
+        for (Nodes::const_iterator it = stored.begin (); it != stored.end (); ++it)
+        {
+            if (it->first != hash)
+            {
+                Blob data (it->second);
+                getApp().getNodeStore ().store (hotACCOUNT_NODE, 0, data, it->first);
+            }
+        }
+
+        return map;
+    }
+
+    void testVisitLeaves ()
+    {
+        testcase ("visitLeaves");
+
+        FullBelowCache fullBelowCache ("test.full_below", get_seconds_clock ());
+        SHAMap source (smtFREE, fullBelowCache);
+        std::vector <uint256> const keys (fill (source, 2000));
+
+        SHAMap::pointer map (makeUncached (source, getNodes (source, true), fullBelowCache));
+        expect (map->size () == 1, "Only the root is in memory");
+
+        std::vector <uint256> visited;
+        map->visitLeaves ([&visited] (SHAMapItem::ref item)
+        {
+            visited.push_back (item->getTag ());
+        });
+
+        expect (visited == keys, "Every leaf once, in key order");
+    }
+
+    void testWalkMap ()
+    {
+        testcase ("walkMap");
+
+        FullBelowCache fullBelowCache ("test.full_below", get_seconds_clock ());
+        SHAMap source (smtFREE, fullBelowCache);
+        fill (source, 2000);
+
+        // Store the inner nodes only, so every leaf is reported missing
+        Nodes const all (getNodes (source, true));
+        Nodes const inner (getNodes (source, false));
+
+        std::vector <uint256> leaves;
+
+        for (Nodes::const_iterator it = all.begin (); it != all.end (); ++it)
+        {
+            if (inner.find (it->first) == inner.end ())
+                leaves.push_back (it->first);
+        }
+
+        SHAMap::pointer map (makeUncached (source, inner, fullBelowCache));
+        expect (map->size () == 1, "Only the root is in memory");
+
+        std::vector <SHAMapMissingNode> missingNodes;
+        map->walkMap (missingNodes, std::numeric_limits <int>::max ());
+
+        std::vector <uint256> missing;
+
+        BOOST_FOREACH (SHAMapMissingNode const& node, missingNodes)
+            missing.push_back (node.getNodeHash ());
+
+        std::sort (missing.begin (), missing.end ());
+
+        expect (!leaves.empty () && (missing == leaves), "Every leaf once");
+    }
+
+    void run ()
+    {
+        testVisitLeaves ();
+        testWalkMap ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SHAMapTraverse,ripple_app,ripple);
+
 } // ripple
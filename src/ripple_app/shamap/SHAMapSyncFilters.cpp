@@ -40,8 +40,8 @@ void ConsensusTransSetSF::gotNode (bool fromFilter, const SHAMapNode& id, uint25
         try
         {
             Serializer s (nodeData.begin () + 4, nodeData.end ()); // skip prefix
-            SerializerIterator sit (s);
-            SerializedTransaction::pointer stx = boost::make_shared<SerializedTransaction> (boost::ref (sit));
+            SerializedTransaction::pointer stx =
+                getApp().getMasterTransaction ().fetchParsed (nodeHash, s);
             assert (stx->getTransactionID () == nodeHash);
             getApp().getJobQueue ().addJob (jtTRANSACTION, "TXS->TXN",
                                            BIND_TYPE (&NetworkOPs::submitTransaction, &getApp().getOPs (), P_1, stx, NetworkOPs::stCallback ()));
@@ -136,28 +136,11 @@ void Transaction::setStatus (TransStatus ts, std::uint32_t lseq)
     mInLedger   = lseq;
 }
 
-Transaction::pointer Transaction::transactionFromSQL (Database* db, bool bValidate)
+Transaction::pointer Transaction::transactionFromBlob (Blob const& rawTxn,
+    std::string const& status, std::uint32_t inLedger, bool bValidate)
 {
-    Serializer rawTxn;
-    std::string status;
-    std::uint32_t inLedger;
-
-    int txSize = 2048;
-    rawTxn.resize (txSize);
-
-    db->getStr ("Status", status);
-    inLedger = db->getInt ("LedgerSeq");
-    txSize = db->getBinary ("RawTxn", &*rawTxn.begin (), rawTxn.getLength ());
-
-    if (txSize > rawTxn.getLength ())
-    {
-        rawTxn.resize (txSize);
-        db->getBinary ("RawTxn", &*rawTxn.begin (), rawTxn.getLength ());
-    }
-
-    rawTxn.resize (txSize);
-
-    SerializerIterator it (rawTxn);
+    Serializer s (rawTxn);
+    SerializerIterator it (s);
     SerializedTransaction::pointer txn = boost::make_shared<SerializedTransaction> (boost::ref (it));
     Transaction::pointer tr = boost::make_shared<Transaction> (txn, bValidate);
 
@@ -202,6 +185,7 @@ Transaction::pointer Transaction::transactionFromSQL (const std::string& sql)
 {
     Serializer rawTxn;
     std::string status;
+    std::string transID;
     std::uint32_t inLedger;
 
     int txSize = 2048;
@@ -224,10 +208,22 @@ Transaction::pointer Transaction::transactionFromSQL (const std::string& sql)
             db->getBinary ("RawTxn", &*rawTxn.begin (), rawTxn.getLength ());
         }
 
+        db->getStr ("TransID", transID);
+
         db->endIterRows ();
     }
     rawTxn.resize (txSize);
 
+    if (txSize == 0)
+    {
+        Blob raw, meta;
+
+        if (!Ledger::loadTransactionBlobs (inLedger, uint256 (transID), raw, meta))
+            return Transaction::pointer ();
+
+        rawTxn = Serializer (raw);
+    }
+
     SerializerIterator it (rawTxn);
     SerializedTransaction::pointer txn = boost::make_shared<SerializedTransaction> (boost::ref (it));
     Transaction::pointer tr = boost::make_shared<Transaction> (txn, true);
@@ -271,7 +267,7 @@ Transaction::pointer Transaction::transactionFromSQL (const std::string& sql)
 
 Transaction::pointer Transaction::load (uint256 const& id)
 {
-    std::string sql = "SELECT LedgerSeq,Status,RawTxn FROM Transactions WHERE TransID='";
+    std::string sql = "SELECT TransID,LedgerSeq,Status,RawTxn FROM Transactions WHERE TransID='";
     sql.append (id.GetHex ());
     sql.append ("';");
     return transactionFromSQL (sql);
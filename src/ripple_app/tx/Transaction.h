@@ -56,7 +56,12 @@ public:
     Transaction (SerializedTransaction::ref st, bool bValidate);
 
     static Transaction::pointer sharedTransaction (Blob const & vucTransaction, bool bValidate);
-    static Transaction::pointer transactionFromSQL (Database * db, bool bValidate);
+    /** Build a transaction from the columns of its row.
+        This lets callers read the rows while holding the database lock
+        and load the transactions of rows without blobs after releasing it.
+    */
+    static Transaction::pointer transactionFromBlob (Blob const& rawTxn,
+        std::string const& status, std::uint32_t inLedger, bool bValidate);
 
     Transaction (
         TxType ttKind,
@@ -197,7 +197,7 @@ void TransactionAcquire::trigger (Peer::ptr const& peer)
     }
 }
 
-SHAMapAddNode TransactionAcquire::takeNodes (const std::list<SHAMapNode>& nodeIDs,
+SHAMapAddNode TransactionAcquire::takeNodes (const std::vector<SHAMapNode>& nodeIDs,
         const std::list< Blob >& data, Peer::ptr const& peer)
 {
     if (mComplete)
@@ -217,7 +217,7 @@ SHAMapAddNode TransactionAcquire::takeNodes (const std::list<SHAMapNode>& nodeID
         if (nodeIDs.empty ())
             return SHAMapAddNode::invalid ();
 
-        std::list<SHAMapNode>::const_iterator nodeIDit = nodeIDs.begin ();
+        std::vector<SHAMapNode>::const_iterator nodeIDit = nodeIDs.begin ();
         std::list< Blob >::const_iterator nodeDatait = data.begin ();
         ConsensusTransSetSF sf (getApp().getTempNodeCache ());
 
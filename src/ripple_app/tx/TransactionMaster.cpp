@@ -22,6 +22,9 @@ namespace ripple {
 TransactionMaster::TransactionMaster ()
     : mCache ("TransactionCache", 65536, 1800, get_seconds_clock (),
         LogPartition::getJournal <TaggedCacheLog> ())
+    , mParsed ("ParsedTransactionCache", 65536, 1800, get_seconds_clock (),
+        LogPartition::getJournal <TaggedCacheLog> ())
+    , mParses (0)
 {
 }
 
@@ -58,24 +61,22 @@ SerializedTransaction::pointer TransactionMaster::fetch (SHAMapItem::ref item,
         bool checkDisk, std::uint32_t uCommitLedger)
 {
     SerializedTransaction::pointer  txn;
-    Transaction::pointer            iTx = getApp().getMasterTransaction ().fetch (item->getTag (), false);
+    Transaction::pointer            iTx = fetch (item->getTag (), false);
 
     if (!iTx)
     {
 
         if (type == SHAMapTreeNode::tnTRANSACTION_NM)
         {
-            SerializerIterator sit (item->peekSerializer ());
-            txn = boost::make_shared<SerializedTransaction> (boost::ref (sit));
+            txn = fetchParsed (item->getTag (), item->peekSerializer ());
         }
         else if (type == SHAMapTreeNode::tnTRANSACTION_MD)
         {
             Serializer s;
             int length;
             item->peekSerializer ().getVL (s.modData (), 0, length);
-            SerializerIterator sit (s);
 
-            txn = boost::make_shared<SerializedTransaction> (boost::ref (sit));
+            txn = fetchParsed (item->getTag (), s);
         }
     }
     else
@@ -89,6 +90,31 @@ SerializedTransaction::pointer TransactionMaster::fetch (SHAMapItem::ref item,
     return txn;
 }
 
+SerializedTransaction::pointer TransactionMaster::fetchParsed (
+    uint256 const& txnID, Serializer& raw)
+{
+    SerializedTransaction::pointer txn = mParsed.fetch (txnID);
+
+    if (txn)
+        return txn;
+
+    Transaction::pointer const iTx = mCache.fetch (txnID);
+
+    if (iTx)
+    {
+        txn = iTx->getSTransaction ();
+    }
+    else
+    {
+        SerializerIterator sit (raw);
+        txn = boost::make_shared<SerializedTransaction> (boost::ref (sit));
+        ++mParses;
+    }
+
+    mParsed.canonicalize (txnID, txn);
+    return txn;
+}
+
 bool TransactionMaster::canonicalize (Transaction::pointer* pTransaction)
 {
     Transaction::pointer txn (*pTransaction);
@@ -99,7 +125,14 @@ bool TransactionMaster::canonicalize (Transaction::pointer* pTransaction)
         return false;
 
     // VFALCO NOTE canonicalize can change the value of txn!
-    if (mCache.canonicalize (tid, txn))
+    bool const had (mCache.canonicalize (tid, txn));
+
+    // Paths that only see the serialized form can now share this one
+    SerializedTransaction::pointer stx (txn->getSTransaction ());
+    if (stx)
+        mParsed.canonicalize (tid, stx);
+
+    if (had)
     {
         *pTransaction = txn;
         return true;
@@ -113,6 +146,7 @@ bool TransactionMaster::canonicalize (Transaction::pointer* pTransaction)
 void TransactionMaster::sweep (void)
 {
     mCache.sweep ();
+    mParsed.sweep ();
 }
 
 } // ripple
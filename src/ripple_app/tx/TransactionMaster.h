@@ -23,6 +23,11 @@
 namespace ripple {
 
 // Tracks all transactions in memory
+//
+// Parsed transactions are also kept by ID, so that a transaction seen
+// on relay, in a proposed set, in a ledger and when publishing is only
+// deserialized once. Parsed transactions are shared and must not be
+// modified; their signature status is shared along with them.
 
 class TransactionMaster : beast::LeakChecked <TransactionMaster>
 {
@@ -33,6 +38,25 @@ public:
     SerializedTransaction::pointer  fetch (SHAMapItem::ref item, SHAMapTreeNode:: TNType type,
                                            bool checkDisk, std::uint32_t uCommitLedger);
 
+    /** Returns the parsed transaction with the given ID.
+        The serialized form is only parsed if no parsed copy is in memory.
+        @param txnID The transaction ID, which the caller must trust.
+        @param raw The serialized transaction, without metadata.
+        Throws if the transaction must be parsed and is malformed.
+    */
+    SerializedTransaction::pointer  fetchParsed (uint256 const& txnID, Serializer& raw);
+
+    /** Returns the number of transactions deserialized by fetchParsed. */
+    std::uint64_t getParseCount () const
+    {
+        return mParses.load ();
+    }
+
+    float getParseHitRate ()
+    {
+        return mParsed.getHitRate ();
+    }
+
     // return value: true = we had the transaction already
     bool inLedger (uint256 const& hash, std::uint32_t ledger);
     bool canonicalize (Transaction::pointer* pTransaction);
@@ -40,6 +64,8 @@ public:
 
 private:
     TaggedCache <uint256, Transaction> mCache;
+    TaggedCache <uint256, SerializedTransaction> mParsed;
+    std::atomic <std::uint64_t> mParses;
 };
 
 } // ripple
@@ -34,6 +34,7 @@ WSConnection::WSConnection (Resource::Manager& resourceManager,
     , m_pingTimer (io_service)
     , m_sentPing (false)
     , m_receiveQueueRunning (false)
+    , m_concurrentCommands (0)
     , m_isDead (false)
     , m_io_service (io_service)
 {
@@ -122,6 +123,25 @@ void WSConnection::returnMessage (message_ptr ptr)
     }
 }
 
+bool WSConnection::startConcurrent (int limit)
+{
+    ScopedLockType sl (m_receiveQueueMutex);
+
+    if (m_isDead || (m_concurrentCommands >= limit))
+        return false;
+
+    ++m_concurrentCommands;
+    return true;
+}
+
+void WSConnection::endConcurrent ()
+{
+    ScopedLockType sl (m_receiveQueueMutex);
+
+    assert (m_concurrentCommands > 0);
+    --m_concurrentCommands;
+}
+
 Json::Value WSConnection::invokeCommand (Json::Value& jvRequest)
 {
     if (getConsumer().disconnect ())
@@ -52,6 +52,12 @@ public:
     message_ptr getMessage ();
     bool checkMessage ();
     void returnMessage (message_ptr ptr);
+
+    /** Reserve a slot for a command run outside the receive queue.
+        @return `false` if `limit` commands are already in flight.
+    */
+    bool startConcurrent (int limit);
+    void endConcurrent ();
     Json::Value invokeCommand (Json::Value& jvRequest);
 
 protected:
@@ -65,6 +71,7 @@ protected:
     boost::asio::deadline_timer m_pingTimer;
     bool m_sentPing;
     bool m_receiveQueueRunning;
+    int m_concurrentCommands;
     bool m_isDead;
     boost::asio::io_service& m_io_service;
 
@@ -392,12 +392,73 @@ public:
                     job.rename (std::string ("WSClient::") + jCmd.asString());
             }
 
-            send (cpClient, conn->invokeCommand (jvRequest), false);
+            if (isConcurrent (jvRequest) &&
+                conn->startConcurrent (getConfig ().WEBSOCKET_CONCURRENCY))
+            {
+                getApp().getJobQueue ().addJob (jtCLIENT, "WSClient::concurrent",
+                    BIND_TYPE (&WSServerHandler<endpoint_type>::do_concurrent,
+                        this, P_1, cpClient, conn, jvRequest));
+            }
+            else
+            {
+                send (cpClient, conn->invokeCommand (jvRequest), false);
+            }
         }
 
         return true;
     }
 
+    // Runs a command that does not have to wait for the ones before it.
+    // The client matches the response to its request by the "id".
+    void do_concurrent (Job& job, connection_ptr cpClient, wsc_ptr conn, Json::Value jvRequest)
+    {
+        ConcurrentSlot slot (conn);
+
+        job.rename (std::string ("WSClient::") + jvRequest["command"].asString ());
+
+        send (cpClient, conn->invokeCommand (jvRequest), false);
+    }
+
+    // Gives back the connection's concurrent command slot, even if the
+    // command throws.
+    class ConcurrentSlot
+    {
+    public:
+        explicit ConcurrentSlot (wsc_ptr const& conn)
+            : m_conn (conn)
+        {
+        }
+
+        ~ConcurrentSlot ()
+        {
+            m_conn->endConcurrent ();
+        }
+
+    private:
+        wsc_ptr const& m_conn;
+    };
+
+    // Commands without an id have no way to match their response, the
+    // subscription commands must take effect in the order sent, and
+    // transactions must be signed and applied in the order sent so that
+    // their sequence numbers line up.
+    static bool isConcurrent (Json::Value const& jvRequest)
+    {
+        if (getConfig ().WEBSOCKET_CONCURRENCY == 0)
+            return false;
+
+        if (!jvRequest.isMember ("id") || !jvRequest["command"].isString ())
+            return false;
+
+        std::string const strCommand (jvRequest["command"].asString ());
+
+        return (strCommand != "subscribe") &&
+            (strCommand != "unsubscribe") &&
+            (strCommand != "path_find") &&
+            (strCommand != "submit") &&
+            (strCommand != "sign");
+    }
+
     boost::asio::ssl::context& get_ssl_context ()
     {
         return m_ssl_context;
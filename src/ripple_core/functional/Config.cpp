@@ -18,6 +18,8 @@
 //==============================================================================
 
 #include "../../beast/modules/beast_core/text/LexicalCast.h"
+#include "../../beast/modules/beast_core/system/SystemStats.h"
+#include "../../beast/beast/unit_test/suite.h"
 
 namespace ripple {
 
@@ -103,6 +105,7 @@ Config::Config ()
     WEBSOCKET_PROXY_SECURE  = 1;
     WEBSOCKET_SECURE        = 0;
     WEBSOCKET_PING_FREQ     = (5 * 60);
+    WEBSOCKET_CONCURRENCY   = 0;
     NUMBER_CONNECTIONS      = 30;
 
     // a new ledger every minute
@@ -135,11 +138,13 @@ Config::Config ()
 
     LEDGER_HISTORY          = 256;
     FETCH_DEPTH             = 1000000000;
+    TXN_DB_BLOBS            = true;
 
     PATH_SEARCH_OLD         = DEFAULT_PATH_SEARCH_OLD;
     PATH_SEARCH             = DEFAULT_PATH_SEARCH;
     PATH_SEARCH_FAST        = DEFAULT_PATH_SEARCH_FAST;
     PATH_SEARCH_MAX         = DEFAULT_PATH_SEARCH_MAX;
+    PATH_GRAPH              = false;
 
     ACCOUNT_PROBE_MAX       = 10;
 
@@ -150,6 +155,7 @@ Config::Config ()
     ELB_SUPPORT             = false;
     RUN_STANDALONE          = false;
     doImport                = false;
+    doVacuum                = false;
     START_UP                = NORMAL;
 }
 
@@ -166,6 +172,7 @@ void Config::setup (const std::string& strConf, bool bQuiet)
 
     QUIET       = bQuiet;
     NODE_SIZE   = 0;
+    NODE_SIZE_AUTO = false;
 
     strDbPath           = Helpers::getDatabaseDirName ();
     strConfFile         = strConf.empty () ? Helpers::getConfigFileName () : strConf;
@@ -425,6 +432,13 @@ void Config::load ()
                     NODE_SIZE = 3;
                 else if (strTemp == "huge")
                     NODE_SIZE = 4;
+                else if (strTemp == "auto")
+                {
+                    NODE_SIZE = getAutoNodeSize (
+                        beast::SystemStats::getMemorySizeInMegabytes (),
+                        beast::SystemStats::getNumCpus ());
+                    NODE_SIZE_AUTO = true;
+                }
                 else
                 {
                     NODE_SIZE = beast::lexicalCastThrow <int> (strTemp);
@@ -466,6 +480,9 @@ void Config::load ()
             if (SectionSingleB (secConfig, SECTION_WEBSOCKET_PING_FREQ, strTemp))
                 WEBSOCKET_PING_FREQ = beast::lexicalCastThrow <int> (strTemp);
 
+            if (SectionSingleB (secConfig, SECTION_WEBSOCKET_CONCURRENCY, strTemp))
+                WEBSOCKET_CONCURRENCY = std::max (0, beast::lexicalCastThrow <int> (strTemp));
+
             SectionSingleB (secConfig, SECTION_WEBSOCKET_SSL_CERT, WEBSOCKET_SSL_CERT);
             SectionSingleB (secConfig, SECTION_WEBSOCKET_SSL_CHAIN, WEBSOCKET_SSL_CHAIN);
             SectionSingleB (secConfig, SECTION_WEBSOCKET_SSL_KEY, WEBSOCKET_SSL_KEY);
@@ -568,6 +585,18 @@ void Config::load ()
                     FETCH_DEPTH = 10;
             }
 
+            if (SectionSingleB (secConfig, SECTION_TRANSACTION_BLOBS, strTemp))
+            {
+                boost::to_lower (strTemp);
+
+                if (strTemp == "ledger")
+                    TXN_DB_BLOBS = false;
+                else if (strTemp == "database")
+                    TXN_DB_BLOBS = true;
+                else
+                    throw std::runtime_error ("Invalid " SECTION_TRANSACTION_BLOBS);
+            }
+
             if (SectionSingleB (secConfig, SECTION_PATH_SEARCH_OLD, strTemp))
                 PATH_SEARCH_OLD     = beast::lexicalCastThrow <int> (strTemp);
             if (SectionSingleB (secConfig, SECTION_PATH_SEARCH, strTemp))
@@ -576,6 +605,8 @@ void Config::load ()
                 PATH_SEARCH_FAST    = beast::lexicalCastThrow <int> (strTemp);
             if (SectionSingleB (secConfig, SECTION_PATH_SEARCH_MAX, strTemp))
                 PATH_SEARCH_MAX     = beast::lexicalCastThrow <int> (strTemp);
+            if (SectionSingleB (secConfig, SECTION_PATH_GRAPH, strTemp))
+                PATH_GRAPH          = beast::lexicalCastThrow <bool> (strTemp);
 
             if (SectionSingleB (secConfig, SECTION_ACCOUNT_PROBE_MAX, strTemp))
                 ACCOUNT_PROBE_MAX   = beast::lexicalCastThrow <int> (strTemp);
@@ -618,6 +649,9 @@ int Config::getSize (SizedItemName item)
         { siTreeCacheSize,      {   8192,   65536,  131072, 131072,     0       } },
         { siTreeCacheAge,       {   30,     60,     90,     120,        900     } },
 
+        { siProofCacheSize,     {   4096,   8192,   16384,  32768,      65536   } },
+        { siProofCacheAge,      {   30,     60,     120,    120,        300     } },
+
         { siSLECacheSize,       {   4096,   8192,   16384,  65536,      0       } },
         { siSLECacheAge,        {   30,     60,     90,     120,        300     } },
 
@@ -639,6 +673,36 @@ int Config::getSize (SizedItemName item)
     return -1;
 }
 
+std::string Config::getNodeSizeName () const
+{
+    static char const* const names [] =
+        { "tiny", "small", "medium", "large", "huge" };
+
+    return names [NODE_SIZE];
+}
+
+int Config::getAutoNodeSize (int memoryMegabytes, int cpuCount)
+{
+    // Smallest amount of memory, in megabytes, for each column. These are a
+    // little under 2, 4, 8 and 16 gigabytes since the reported size leaves
+    // out what the kernel reserves.
+    static int const minMemory [] = { 0, 1792, 3584, 7168, 14336 };
+
+    // Smallest number of cores for each column
+    static int const minCpus [] = { 0, 1, 2, 4, 4 };
+
+    int size = 0;
+
+    while ((size < 4) &&
+        (memoryMegabytes >= minMemory [size + 1]) &&
+        (cpuCount >= minCpus [size + 1]))
+    {
+        ++size;
+    }
+
+    return size;
+}
+
 //------------------------------------------------------------------------------
 //
 // VFALCO NOTE Clean members area
@@ -779,6 +843,54 @@ beast::File const& Config::getModuleDatabasePath ()
     return m_moduleDbPath;
 }
 
+//------------------------------------------------------------------------------
+
+class Config_test : public beast::unit_test::suite
+{
+public:
+    void testAutoNodeSizeMemory ()
+    {
+        testcase ("auto node size memory");
+
+        // Plenty of cores, so only the memory decides
+        expect (Config::getAutoNodeSize (0, 64) == 0);
+        expect (Config::getAutoNodeSize (1791, 64) == 0);
+        expect (Config::getAutoNodeSize (1792, 64) == 1);
+        expect (Config::getAutoNodeSize (3583, 64) == 1);
+        expect (Config::getAutoNodeSize (3584, 64) == 2);
+        expect (Config::getAutoNodeSize (7167, 64) == 2);
+        expect (Config::getAutoNodeSize (7168, 64) == 3);
+        expect (Config::getAutoNodeSize (14335, 64) == 3);
+        expect (Config::getAutoNodeSize (14336, 64) == 4);
+        expect (Config::getAutoNodeSize (1024 * 1024, 64) == 4);
+    }
+
+    void testAutoNodeSizeCpus ()
+    {
+        testcase ("auto node size cpus");
+
+        // Plenty of memory, so only the cores decide
+        expect (Config::getAutoNodeSize (1024 * 1024, 0) == 0);
+        expect (Config::getAutoNodeSize (1024 * 1024, 1) == 1);
+        expect (Config::getAutoNodeSize (1024 * 1024, 2) == 2);
+        expect (Config::getAutoNodeSize (1024 * 1024, 3) == 2);
+        expect (Config::getAutoNodeSize (1024 * 1024, 4) == 4);
+
+        // Whichever limit is lower wins
+        expect (Config::getAutoNodeSize (3584, 1) == 1);
+        expect (Config::getAutoNodeSize (1792, 4) == 1);
+        expect (Config::getAutoNodeSize (7168, 3) == 2);
+    }
+
+    void run ()
+    {
+        testAutoNodeSizeMemory ();
+        testAutoNodeSizeCpus ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Config,ripple_core,ripple);
+
 //
 //
 //------------------------------------------------------------------------------
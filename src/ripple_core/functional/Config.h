@@ -67,6 +67,8 @@ enum SizedItemName
     siNodeCacheAge,
     siTreeCacheSize,
     siTreeCacheAge,
+    siProofCacheSize,
+    siProofCacheAge,
     siSLECacheSize,
     siSLECacheAge,
     siLedgerSize,
@@ -334,6 +336,9 @@ public:
         @see parseDelimitedKeyValueString
     */
     bool doImport;
+
+    /** Compact the transaction database with VACUUM at startup. */
+    bool doVacuum;
     beast::StringPairArray importNodeDatabase;
 
     //
@@ -419,6 +424,7 @@ public:
     int                         WEBSOCKET_SECURE;
 
     int                         WEBSOCKET_PING_FREQ;
+    int                         WEBSOCKET_CONCURRENCY;      // Commands with an id in flight per client, 0 = serial
 
     std::string                 WEBSOCKET_SSL_CERT;
     std::string                 WEBSOCKET_SSL_CHAIN;
@@ -443,6 +449,7 @@ public:
     int                         PATH_SEARCH;
     int                         PATH_SEARCH_FAST;
     int                         PATH_SEARCH_MAX;
+    bool                        PATH_GRAPH;                 // Keep a graph of every trust line
 
     // Validation
     RippleAddress               VALIDATION_SEED, VALIDATION_PUB, VALIDATION_PRIV;
@@ -462,7 +469,9 @@ public:
     // Node storage configuration
     std::uint32_t                      LEDGER_HISTORY;
     std::uint32_t                      FETCH_DEPTH;
+    bool                        TXN_DB_BLOBS;           // Keep transaction and metadata blobs in the transaction database
     int                         NODE_SIZE;
+    bool                        NODE_SIZE_AUTO;         // NODE_SIZE was chosen from the hardware
 
     // Client behavior
     int                         ACCOUNT_PROBE_MAX;      // How far to scan for accounts.
@@ -486,6 +495,16 @@ public:
     Config ();
 
     int getSize (SizedItemName);
+
+    /** Returns the name of the configured node size column. */
+    std::string getNodeSizeName () const;
+
+    /** Choose a node size for a machine.
+        The largest column whose caches fit comfortably in the given memory
+        is chosen, limited by the core count since a busy server with few
+        cores can't make use of the larger caches.
+    */
+    static int getAutoNodeSize (int memoryMegabytes, int cpuCount);
     void setup (const std::string& strConf, bool bQuiet);
     void load ();
 };
@@ -60,6 +60,7 @@ struct ConfigSection
 #define SECTION_PATH_SEARCH             "path_search"
 #define SECTION_PATH_SEARCH_FAST        "path_search_fast"
 #define SECTION_PATH_SEARCH_MAX         "path_search_max"
+#define SECTION_PATH_GRAPH              "path_graph"
 #define SECTION_PEER_CONNECT_LOW_WATER  "peer_connect_low_water"
 #define SECTION_PEER_IP                 "peer_ip"
 #define SECTION_PEER_PORT               "peer_port"
@@ -88,6 +89,7 @@ struct ConfigSection
 #define SECTION_SMS_TO                  "sms_to"
 #define SECTION_SMS_URL                 "sms_url"
 #define SECTION_SNTP                    "sntp_servers"
+#define SECTION_TRANSACTION_BLOBS       "transaction_blobs"
 #define SECTION_SSL_VERIFY              "ssl_verify"
 #define SECTION_SSL_VERIFY_FILE         "ssl_verify_file"
 #define SECTION_SSL_VERIFY_DIR          "ssl_verify_dir"
@@ -101,6 +103,7 @@ struct ConfigSection
 #define SECTION_WEBSOCKET_PROXY_PORT   "websocket_proxy_port"
 #define SECTION_WEBSOCKET_PROXY_SECURE "websocket_proxy_secure"
 #define SECTION_WEBSOCKET_PING_FREQ     "websocket_ping_frequency"
+#define SECTION_WEBSOCKET_CONCURRENCY   "websocket_concurrency"
 #define SECTION_WEBSOCKET_IP            "websocket_ip"
 #define SECTION_WEBSOCKET_PORT          "websocket_port"
 #define SECTION_WEBSOCKET_SECURE        "websocket_secure"
@@ -44,6 +44,7 @@ enum JobType
     jtCLIENT,        // A websocket command from the client
     jtRPC,           // A websocket command from the client
     jtUPDATE_PF,     // Update pathfinding requests
+    jtPATH_CALC,     // Help compute the increments of candidate paths
     jtTRANSACTION,   // A transaction received from the network
     jtUNL,           // A Score or Fetch of the UNL (DEPRECATED)
     jtADVANCE,       // Advance validated/acquired ledgers
@@ -242,6 +242,11 @@ public:
         m_workers.setNumberOfThreads (c);
     }
 
+    int getThreadCount ()
+    {
+        return m_workers.getNumberOfThreads ();
+    }
+
 
     LoadEvent::pointer getLoadEvent (JobType t, const std::string& name)
     {
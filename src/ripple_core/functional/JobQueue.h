@@ -53,6 +53,9 @@ public:
 
     virtual void setThreadCount (int c, bool const standaloneMode) = 0;
 
+    // Threads currently serving the queue
+    virtual int getThreadCount () = 0;
+
     // VFALCO TODO Rename these to newLoadEventMeasurement or something similar
     //             since they create the object.
     //
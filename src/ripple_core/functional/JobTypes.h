@@ -67,6 +67,10 @@ public:
         add (jtUPDATE_PF,     "updatePaths",
             maxLimit, true,   false, 0,     0);
 
+        // Help compute the increments of candidate paths
+        add (jtPATH_CALC,     "pathCalc",
+            4,        true,   false, 0,     0);
+
         // A websocket command from the client
         add (jtCLIENT,        "clientCommand",
             maxLimit, true,   false, 2000,  5000);
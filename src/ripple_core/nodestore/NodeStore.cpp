@@ -17,7 +17,10 @@
 */
 //==============================================================================
 
+#include <exception>
+#include <fstream>
 #include <memory>
+#include <thread>
 #include <vector>
 
 // backend support
@@ -26,6 +29,7 @@
 #include "../ripple/rocksdb/ripple_rocksdb.h"
 
 #include "../beast/beast/cxx14/memory.h"
+#include "../beast/modules/beast_core/thread/DeadlineTimer.h"
 
 #include "../../ripple/common/seconds_clock.h"
 #include "../../ripple/common/TaggedCache.h"
@@ -48,6 +52,7 @@
 
 #include "impl/Backend.cpp"
 #include "impl/BatchWriter.cpp"
+#  include "impl/FastTier.h"
 # include "impl/DatabaseImp.h"
 #include "impl/Database.cpp"
 #include "impl/DummyScheduler.cpp"
@@ -72,6 +72,16 @@ public:
     */
     virtual void storeBatch (Batch const& batch) = 0;
 
+    /** Remove a single object.
+        This is used to demote objects out of a bounded fast backend, so
+        any backend which can be a fast tier must really remove it,
+        including a store of the object which has not been written yet.
+        Removing an object which is not present does nothing.
+        @note This will be called concurrently.
+        @param key A pointer to the key data.
+    */
+    virtual void remove (void const* key) = 0;
+
     /** Visit every object in the database
         This is usually called during import.
         @note This routine will not be called concurrently with itself
@@ -82,6 +92,34 @@ public:
     // VFALCO TODO Implement
     //virtual void visitAll (std::function <void (NodeObject::Ptr)> f) = 0;
 
+    /** Visit every object whose key lies in a range.
+        Keys are compared as big-endian numbers, and both ends of the
+        range are included. The default implementation filters the
+        results of @ref visitAll, backends which keep their keys in order
+        should override it with a seek, and override @ref canVisitRange.
+        @note An override may be called concurrently with itself, but not
+              with other methods. The default implementation is not.
+    */
+    virtual void visitRange (uint256 const& first, uint256 const& last,
+        VisitCallback& callback);
+
+    /** Returns `true` if @ref visitRange is overridden with a seek.
+        Only then is @ref visitParallel allowed to use several threads.
+    */
+    virtual bool canVisitRange ()
+    {
+        return false;
+    }
+
+    /** Visit every object using several threads.
+        The key space is split into equal ranges which are each passed
+        to @ref visitRange on a thread of their own. If the backend
+        cannot visit a range without scanning everything, a single call
+        to @ref visitAll is made instead.
+        @note The callback may be called concurrently.
+    */
+    void visitParallel (VisitCallback& callback, int threadCount);
+
     /** Estimate the number of write operations pending. */
     virtual int getWriteLoad () = 0;
 };
@@ -121,6 +121,32 @@ public:
     // VFALCO TODO Document this.
     virtual float getCacheHitRate () = 0;
 
+    /** Counts of reads that went past the cache to the backends. */
+    struct TierStats
+    {
+        TierStats ()
+            : fastHits (0)
+            , slowHits (0)
+            , misses (0)
+            , fastSize (0)
+        {
+        }
+
+        // Reads satisfied by the fast backend
+        std::uint64_t fastHits;
+        // Reads satisfied by the persistent backend
+        std::uint64_t slowHits;
+        // Reads satisfied by neither backend
+        std::uint64_t misses;
+        // Objects tracked in a bounded fast backend
+        std::size_t fastSize;
+    };
+
+    /** Retrieve backend read counts for each tier.
+        @note This can be called concurrently.
+    */
+    virtual void getTierStats (TierStats& stats) = 0;
+
     // VFALCO TODO Document this.
     //        TODO Document the parameter meanings.
     virtual void tune (int size, int age) = 0;
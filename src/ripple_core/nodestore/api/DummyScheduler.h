@@ -30,6 +30,7 @@ public:
     DummyScheduler ();
     ~DummyScheduler ();
     void scheduleTask (Task& task);
+    void onBatchWrite (BatchWriteReport const& report);
     void scheduledTasksStopped ();
 };
 
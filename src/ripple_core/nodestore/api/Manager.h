@@ -55,7 +55,10 @@ public:
             HyperLevelDB, LevelDBFactory, SQLite, MDB
 
         If the fastBackendParameter is omitted or empty, no ephemeral database
-        is used. If the scheduler parameter is omited or unspecified, a
+        is used. The fast backend parameters may include 'tier_size', which
+        bounds the number of objects kept in the fast backend, and
+        'tier_admit', the number of requests for an object before it is
+        placed there. If the scheduler parameter is omited or unspecified, a
         synchronous scheduler is used which performs all tasks immediately on
         the caller's thread.
 
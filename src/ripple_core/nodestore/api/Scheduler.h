@@ -23,6 +23,19 @@
 namespace ripple {
 namespace NodeStore {
 
+/** Contains information about a batch write operation. */
+struct BatchWriteReport
+{
+    // Time spent in the backend writing the batch
+    std::chrono::milliseconds elapsed;
+
+    // Number of objects written
+    int writeCount;
+
+    // Number of objects still waiting to be written
+    int pendingCount;
+};
+
 /** Scheduling for asynchronous backend activity
     
     For improved performance, a backend has the option of performing writes
@@ -42,6 +55,11 @@ public:
         foreign thread.
     */
     virtual void scheduleTask (Task& task) = 0;
+
+    /** Reports the completion of a batch write.
+        Allows the scheduler to monitor the node store's performance.
+    */
+    virtual void onBatchWrite (BatchWriteReport const& report) = 0;
 };
 
 }
@@ -95,7 +95,11 @@ public:
 
     Status fetch (void const* key, NodeObject::Ptr* pObject)
     {
-        pObject->reset ();
+        // An object waiting in the batch isn't on disk yet
+        *pObject = m_batch.fetch (uint256::fromVoid (key));
+
+        if (*pObject != nullptr)
+            return ok;
 
         Status status (ok);
 
@@ -168,13 +172,39 @@ public:
         m_db->Write (options, &wb).ok ();
     }
 
+    void remove (void const* key)
+    {
+        m_batch.remove (uint256::fromVoid (key));
+    }
+
     void visitAll (VisitCallback& callback)
     {
-        hyperleveldb::ReadOptions const options;
+        uint256 const first;
+
+        visitRange (first, ~first, callback);
+    }
+
+    bool canVisitRange ()
+    {
+        return true;
+    }
+
+    void visitRange (uint256 const& first, uint256 const& last,
+        VisitCallback& callback)
+    {
+        hyperleveldb::ReadOptions options;
+
+        // Don't let a scan push the working set out of the block cache
+        options.fill_cache = false;
 
         std::unique_ptr <hyperleveldb::Iterator> it (m_db->NewIterator (options));
 
-        for (it->SeekToFirst (); it->Valid (); it->Next ())
+        hyperleveldb::Slice const end (reinterpret_cast <char const*> (
+            last.begin ()), m_keyBytes);
+
+        for (it->Seek (hyperleveldb::Slice (reinterpret_cast <char const*> (
+                first.begin ()), m_keyBytes));
+            it->Valid () && (it->key ().compare (end) <= 0); it->Next ())
         {
             if (it->key ().size () == m_keyBytes)
             {
@@ -215,6 +245,21 @@ public:
     {
         storeBatch (batch);
     }
+
+    void removeBatch (std::vector <uint256> const& keys)
+    {
+        hyperleveldb::WriteBatch wb;
+
+        BOOST_FOREACH (uint256 const& key, keys)
+        {
+            wb.Delete (hyperleveldb::Slice (
+                reinterpret_cast <char const*> (key.begin ()), m_keyBytes));
+        }
+
+        hyperleveldb::WriteOptions const options;
+
+        m_db->Write (options, &wb).ok ();
+    }
 };
 
 //------------------------------------------------------------------------------
@@ -20,25 +20,127 @@
 namespace ripple {
 namespace NodeStore {
 
-class MemoryBackend : public Backend
+/** A NodeStore backend which keeps every object in RAM.
+
+    Objects are spread over a number of independently locked shards by
+    the leading byte of their hash, so concurrent lookups rarely contend.
+
+    If a journal file is configured, each new object is appended to it,
+    and the whole file is read back sequentially when the backend is
+    opened. Removals are recorded as a key with an empty value. Changes
+    are made and their records buffered under the journal lock, so the
+    records are in the same order as the changes. The buffer is written
+    to the file under a separate lock, so a store only waits for the file
+    when it is the one writing a full buffer. A record left incomplete by
+    a crash is discarded along with anything after it. The journal is
+    written after each batch, once a second while single writes are
+    pending, and when the backend is closed. A crash can lose the last
+    second of single writes, and the machine losing power can lose more,
+    since the file is never synced.
+
+    Once most of the records in the journal are for objects which have
+    since been removed, the journal is rewritten with only the live ones.
+    The flush timer starts a thread for this, and changes made while the
+    new journal is written are added to both journals. Closing the backend
+    abandons a compaction in progress and keeps the old journal.
+*/
+class MemoryBackend
+    : public Backend
+    , public beast::DeadlineTimer::Listener
 {
 public:
-    typedef std::map <uint256 const, NodeObject::Ptr> Map;
+    typedef ripple::unordered_map <uint256, NodeObject::Ptr> Map;
+
+    enum
+    {
+        // Must be a power of two
+        shardCount = 64
+
+        // Fewest records in the journal before it is compacted
+        ,minimumCompactRecords = 65536
+
+        // Largest value size in a journal record. Anything bigger when
+        // loading is treated as the end of the valid records.
+        ,maxRecordBytes = 16 * 1024 * 1024
+
+        // Seconds between flushes of single writes to the journal
+        ,flushSeconds = 1
+
+        // Buffered journal bytes at which a store writes them out
+        ,journalBufferBytes = 1024 * 1024
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+        Map map;
+    };
+
     beast::Journal m_journal;
     size_t const m_keyBytes;
-    Map m_map;
-    Scheduler& m_scheduler;
+    Shard m_shards [shardCount];
+
+    std::string const m_journalPath;
+    bool const m_journaling;
+    // Orders changes and their records
+    std::mutex m_journalMutex;
+    // Held while writing the journal file, and taken before m_journalMutex
+    std::mutex m_streamMutex;
+    std::ofstream m_journalStream;
+    beast::DeadlineTimer m_flushTimer;
+    std::thread m_compactThread;
+    std::atomic <bool> m_closing;
+
+    // Protected by m_journalMutex
+    std::vector <char> m_journalBuffer;
+    bool m_journalFailed;
+    std::size_t m_journalRecords;
+    std::size_t m_liveObjects;
+    bool m_compactWanted;
+    bool m_compactRunning;
+    bool m_compacting;
+
+    // Changes made while compacting, a null object being a removal.
+    // Protected by m_journalMutex
+    std::vector <std::pair <uint256, NodeObject::Ptr>> m_compactLog;
 
     MemoryBackend (size_t keyBytes, Parameters const& keyValues,
-        Scheduler& scheduler, beast::Journal journal)
+        beast::Journal journal)
         : m_journal (journal)
         , m_keyBytes (keyBytes)
-        , m_scheduler (scheduler)
+        , m_journalPath (keyValues ["journal"].toStdString ())
+        , m_journaling (! m_journalPath.empty ())
+        , m_flushTimer (this)
+        , m_closing (false)
+        , m_journalFailed (false)
+        , m_journalRecords (0)
+        , m_liveObjects (0)
+        , m_compactWanted (false)
+        , m_compactRunning (false)
+        , m_compacting (false)
     {
+        if (m_journaling)
+        {
+            openJournal ();
+            m_flushTimer.setRecurringExpiration (flushSeconds);
+        }
     }
 
     ~MemoryBackend ()
     {
+        m_flushTimer.cancel ();
+
+        if (m_journaling)
+        {
+            // A compaction in progress stops at the next shard
+            m_closing = true;
+
+            if (m_compactThread.joinable ())
+                m_compactThread.join ();
+
+            if (! flushJournal ())
+                m_journal.error << "Unable to write memory backend journal";
+        }
     }
 
     std::string getName ()
@@ -48,13 +150,22 @@ public:
 
     //--------------------------------------------------------------------------
 
+    Shard& getShard (uint256 const& hash)
+    {
+        return m_shards [*hash.begin () & (shardCount - 1)];
+    }
+
     Status fetch (void const* key, NodeObject::Ptr* pObject)
     {
         uint256 const hash (uint256::fromVoid (key));
 
-        Map::iterator iter = m_map.find (hash);
+        Shard& shard (getShard (hash));
+
+        std::lock_guard <std::mutex> lock (shard.mutex);
 
-        if (iter != m_map.end ())
+        Map::iterator iter = shard.map.find (hash);
+
+        if (iter != shard.map.end ())
         {
             *pObject = iter->second;
         }
@@ -66,32 +177,517 @@ public:
         return ok;
     }
 
+    // Returns `true` if the object was not already present
+    bool insert (NodeObject::ref object)
+    {
+        Shard& shard (getShard (object->getHash ()));
+
+        std::lock_guard <std::mutex> lock (shard.mutex);
+
+        return shard.map.insert (std::make_pair (
+            object->getHash (), object)).second;
+    }
+
+    // Returns `true` if the object was present
+    bool erase (uint256 const& hash)
+    {
+        Shard& shard (getShard (hash));
+
+        std::lock_guard <std::mutex> lock (shard.mutex);
+
+        return shard.map.erase (hash) != 0;
+    }
+
     void store (NodeObject::ref object)
     {
-        Map::iterator iter = m_map.find (object->getHash ());
+        if (! m_journaling)
+        {
+            insert (object);
+            return;
+        }
+
+        // Checked before inserting, so the map never holds an object
+        // which the journal does not.
+        EncodedBlob encoded;
+        encode (encoded, object);
+
+        bool full (false);
 
-        if (iter == m_map.end ())
         {
-            m_map.insert (std::make_pair (object->getHash (), object));
+            std::lock_guard <std::mutex> lock (m_journalMutex);
+
+            if (insert (object))
+            {
+                appendRecord (m_journalBuffer, encoded.getKey (),
+                    encoded.getData (), encoded.getSize ());
+                recordChange (object->getHash (), object);
+                ++m_liveObjects;
+
+                if (m_journalFailed)
+                    throw std::runtime_error ("Unable to write memory backend journal");
+            }
+
+            full = m_journalBuffer.size () >= journalBufferBytes;
         }
+
+        if (full && ! flushJournal ())
+            throw std::runtime_error ("Unable to write memory backend journal");
     }
 
     void storeBatch (Batch const& batch)
     {
+        if (! m_journaling)
+        {
+            BOOST_FOREACH (NodeObject::ref object, batch)
+                insert (object);
+            return;
+        }
+
+        std::vector <EncodedBlob> encoded (batch.size ());
+
         for (std::size_t i = 0; i < batch.size (); ++i)
-            store (batch [i]);
+            encode (encoded [i], batch [i]);
+
+        {
+            std::lock_guard <std::mutex> lock (m_journalMutex);
+
+            for (std::size_t i = 0; i < batch.size (); ++i)
+            {
+                if (insert (batch [i]))
+                {
+                    appendRecord (m_journalBuffer, encoded [i].getKey (),
+                        encoded [i].getData (), encoded [i].getSize ());
+                    recordChange (batch [i]->getHash (), batch [i]);
+                    ++m_liveObjects;
+                }
+            }
+        }
+
+        if (! flushJournal ())
+            throw std::runtime_error ("Unable to write memory backend journal");
+    }
+
+    void remove (void const* key)
+    {
+        uint256 const hash (uint256::fromVoid (key));
+
+        if (! m_journaling)
+        {
+            erase (hash);
+            return;
+        }
+
+        std::lock_guard <std::mutex> lock (m_journalMutex);
+
+        if (erase (hash))
+        {
+            appendRecord (m_journalBuffer, key, nullptr, 0);
+            recordChange (hash, NodeObject::Ptr ());
+            --m_liveObjects;
+
+            if (m_journalRecords >= minimumCompactRecords &&
+                    m_journalRecords > 2 * m_liveObjects)
+                m_compactWanted = true;
+
+            // The object is gone either way, so a failed write is only
+            // reported. The next store will throw.
+            if (m_journalFailed)
+                m_journal.error << "Unable to write memory backend journal";
+        }
     }
 
     void visitAll (VisitCallback& callback)
     {
-        for (Map::const_iterator iter = m_map.begin (); iter != m_map.end (); ++iter)
-            callback.visitObject (iter->second);
+        Batch objects;
+
+        for (int i = 0; i < shardCount; ++i)
+        {
+            objects.clear ();
+
+            {
+                std::lock_guard <std::mutex> lock (m_shards [i].mutex);
+
+                objects.reserve (m_shards [i].map.size ());
+
+                for (Map::const_iterator iter = m_shards [i].map.begin ();
+                    iter != m_shards [i].map.end (); ++iter)
+                    objects.push_back (iter->second);
+            }
+
+            BOOST_FOREACH (NodeObject::ref object, objects)
+                callback.visitObject (object);
+        }
     }
 
     int getWriteLoad ()
     {
         return 0;
     }
+
+    void onDeadlineTimer (beast::DeadlineTimer&)
+    {
+        if (! flushJournal ())
+            m_journal.error << "Unable to write memory backend journal";
+
+        {
+            std::lock_guard <std::mutex> lock (m_journalMutex);
+
+            if (! m_compactWanted || m_compactRunning || m_closing)
+                return;
+
+            m_compactWanted = false;
+            m_compactRunning = true;
+        }
+
+        // The previous compaction has finished, so this does not wait.
+        // Compacting on our own thread rather than through the Scheduler
+        // lets the destructor stop it, whatever state the Scheduler is in.
+        if (m_compactThread.joinable ())
+            m_compactThread.join ();
+
+        m_compactThread = std::thread (&MemoryBackend::runCompaction, this);
+    }
+
+    void runCompaction ()
+    {
+        try
+        {
+            compactJournal ();
+        }
+        catch (std::exception const& e)
+        {
+            m_journal.error << e.what () << " " << m_journalPath;
+        }
+
+        std::lock_guard <std::mutex> lock (m_journalMutex);
+        m_compactRunning = false;
+    }
+
+    //--------------------------------------------------------------------------
+    //
+    // Journal
+    //
+    // Each record is a 32-bit big endian value size, the key, and the
+    // value encoded the same way as the other backends store it.
+    //
+
+    void encode (EncodedBlob& encoded, NodeObject::ref object)
+    {
+        encoded.prepare (object);
+
+        if (encoded.getSize () > maxRecordBytes)
+            throw std::runtime_error ("Object too large for memory backend journal");
+    }
+
+    void appendRecord (std::vector <char>& buffer,
+        void const* key, void const* data, std::size_t size)
+    {
+        std::uint32_t const header (beast::ByteOrder::swapIfLittleEndian (
+            static_cast <std::uint32_t> (size)));
+
+        char const* const headerBytes (reinterpret_cast <char const*> (&header));
+        char const* const keyBytes (static_cast <char const*> (key));
+        char const* const dataBytes (static_cast <char const*> (data));
+
+        buffer.insert (buffer.end (), headerBytes, headerBytes + sizeof (header));
+        buffer.insert (buffer.end (), keyBytes, keyBytes + m_keyBytes);
+        buffer.insert (buffer.end (), dataBytes, dataBytes + size);
+    }
+
+    void appendRecord (std::vector <char>& buffer,
+        uint256 const& hash, NodeObject::ref object)
+    {
+        if (object == nullptr)
+        {
+            appendRecord (buffer, hash.begin (), nullptr, 0);
+            return;
+        }
+
+        EncodedBlob encoded;
+
+        encoded.prepare (object);
+
+        appendRecord (buffer, encoded.getKey (), encoded.getData (),
+            encoded.getSize ());
+    }
+
+    // The caller checks the stream afterwards
+    static void writeBuffer (std::ofstream& stream, std::vector <char> const& buffer)
+    {
+        if (! buffer.empty ())
+            stream.write (&buffer [0], buffer.size ());
+    }
+
+    // Write the buffered records to the journal file.
+    // The caller must not hold m_journalMutex.
+    // Returns `false` if the journal could not be written.
+    bool flushJournal ()
+    {
+        std::lock_guard <std::mutex> streamLock (m_streamMutex);
+
+        std::vector <char> buffer;
+
+        {
+            std::lock_guard <std::mutex> lock (m_journalMutex);
+
+            if (m_journalBuffer.empty ())
+                return ! m_journalFailed;
+
+            buffer.swap (m_journalBuffer);
+        }
+
+        writeBuffer (m_journalStream, buffer);
+        m_journalStream.flush ();
+
+        std::lock_guard <std::mutex> lock (m_journalMutex);
+
+        if (! m_journalStream)
+            m_journalFailed = true;
+
+        return ! m_journalFailed;
+    }
+
+    // Count a record added to the journal, and keep it for the new
+    // journal if one is being written.
+    // The caller must hold m_journalMutex.
+    void recordChange (uint256 const& hash, NodeObject::ref object)
+    {
+        ++m_journalRecords;
+
+        if (m_compacting)
+            m_compactLog.push_back (std::make_pair (hash, object));
+    }
+
+    // Rewrite the journal with only the live objects. The new journal is
+    // written beside the old one and renamed over it, so a crash part way
+    // through leaves the old journal intact.
+    //
+    // The live objects are written without holding the journal lock, and
+    // each shard is only locked while its objects are copied out. Changes
+    // made meanwhile are appended to the new journal before it replaces
+    // the old one. A change may repeat what was already written, which is
+    // harmless since replaying a record is idempotent. Closing the backend
+    // abandons the new journal.
+    void compactJournal ()
+    {
+        std::string const tempPath (m_journalPath + ".compact");
+
+        {
+            std::lock_guard <std::mutex> lock (m_journalMutex);
+            m_compacting = true;
+        }
+
+        std::ofstream stream (tempPath.c_str (),
+            std::ios::out | std::ios::binary | std::ios::trunc);
+
+        std::size_t count (0);
+
+        try
+        {
+            Batch objects;
+            std::vector <char> buffer;
+
+            for (int i = 0; stream && ! m_closing && i < shardCount; ++i)
+            {
+                objects.clear ();
+
+                {
+                    std::lock_guard <std::mutex> lock (m_shards [i].mutex);
+
+                    objects.reserve (m_shards [i].map.size ());
+
+                    for (Map::const_iterator iter = m_shards [i].map.begin ();
+                        iter != m_shards [i].map.end (); ++iter)
+                        objects.push_back (iter->second);
+                }
+
+                buffer.clear ();
+
+                BOOST_FOREACH (NodeObject::ref object, objects)
+                    appendRecord (buffer, object->getHash (), object);
+
+                writeBuffer (stream, buffer);
+
+                count += objects.size ();
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard <std::mutex> lock (m_journalMutex);
+            m_compacting = false;
+            m_compactLog.clear ();
+            throw;
+        }
+
+        // Records buffered from here on go to whichever journal is open
+        // once this lock is released.
+        std::lock_guard <std::mutex> streamLock (m_streamMutex);
+
+        std::vector <char> pending;
+        std::size_t records (0);
+        bool const abandon (m_closing);
+
+        {
+            std::lock_guard <std::mutex> lock (m_journalMutex);
+
+            if (! abandon)
+            {
+                std::vector <char> buffer;
+
+                for (std::size_t i = 0; i < m_compactLog.size (); ++i)
+                    appendRecord (buffer, m_compactLog [i].first, m_compactLog [i].second);
+
+                writeBuffer (stream, buffer);
+
+                count += m_compactLog.size ();
+
+                // Records added after this are counted on top of the new
+                // journal. If it cannot replace the old one, the count is
+                // low until the next compaction, which is harmless.
+                records = m_journalRecords;
+                m_journalRecords = count;
+            }
+
+            m_compacting = false;
+            m_compactLog.clear ();
+
+            // These belong in the old journal, which is kept if the
+            // new one cannot replace it.
+            pending.swap (m_journalBuffer);
+        }
+
+        stream.close ();
+
+        writeBuffer (m_journalStream, pending);
+
+        if (abandon || ! stream)
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove (tempPath, ec);
+
+            if (abandon)
+                return;
+
+            throw std::runtime_error ("Unable to compact memory backend journal");
+        }
+
+        m_journalStream.close ();
+
+        boost::system::error_code ec;
+        boost::filesystem::rename (tempPath, m_journalPath, ec);
+
+        // If the rename failed this reopens the old journal, which
+        // still has every change.
+        m_journalStream.open (m_journalPath.c_str (),
+            std::ios::out | std::ios::binary | std::ios::app);
+
+        if (ec)
+            throw std::runtime_error ("Unable to compact memory backend journal");
+
+        if (! m_journalStream)
+        {
+            std::lock_guard <std::mutex> lock (m_journalMutex);
+            m_journalFailed = true;
+
+            throw std::runtime_error ("Unable to reopen memory backend journal");
+        }
+
+        m_journal.info << "Compacted " << records << " records to " <<
+            count << " in " << m_journalPath;
+    }
+
+    void openJournal ()
+    {
+        std::uint64_t const validBytes (loadJournal ());
+
+        boost::system::error_code ec;
+        boost::uintmax_t const fileBytes (
+            boost::filesystem::file_size (m_journalPath, ec));
+
+        if (! ec && fileBytes > validBytes)
+        {
+            m_journal.warning << "Discarding " << (fileBytes - validBytes) <<
+                " bytes from the end of " << m_journalPath;
+
+            boost::filesystem::resize_file (m_journalPath, validBytes, ec);
+
+            if (ec)
+                throw std::runtime_error (
+                    "Unable to truncate memory backend journal");
+        }
+
+        m_journalStream.open (m_journalPath.c_str (),
+            std::ios::out | std::ios::binary | std::ios::app);
+
+        if (! m_journalStream)
+            throw std::runtime_error ("Unable to open memory backend journal");
+    }
+
+    // Returns the number of bytes which were read successfully
+    std::uint64_t loadJournal ()
+    {
+        std::ifstream stream (m_journalPath.c_str (),
+            std::ios::in | std::ios::binary);
+
+        if (! stream)
+            return 0;
+
+        std::uint64_t validBytes (0);
+        std::size_t count (0);
+        std::vector <char> key (m_keyBytes);
+        std::vector <char> data;
+
+        for (;;)
+        {
+            std::uint32_t header;
+
+            if (! stream.read (reinterpret_cast <char*> (&header),
+                    sizeof (header)))
+                break;
+
+            std::size_t const size (
+                beast::ByteOrder::swapIfLittleEndian (header));
+
+            // A damaged size would otherwise allocate up to 4GB
+            if (size > maxRecordBytes)
+                break;
+
+            data.resize (size);
+
+            if (! stream.read (&key [0], m_keyBytes) ||
+                    (size != 0 && ! stream.read (&data [0], size)))
+                break;
+
+            uint256 const hash (uint256::fromVoid (&key [0]));
+
+            if (size == 0)
+            {
+                getShard (hash).map.erase (hash);
+            }
+            else
+            {
+                DecodedBlob decoded (&key [0], &data [0], size);
+
+                if (! decoded.wasOk ())
+                    break;
+
+                getShard (hash).map [hash] = decoded.createObject ();
+            }
+
+            validBytes += sizeof (header) + m_keyBytes + size;
+            ++count;
+        }
+
+        m_journalRecords = count;
+        m_liveObjects = 0;
+        for (int i = 0; i < shardCount; ++i)
+            m_liveObjects += m_shards [i].map.size ();
+
+        m_journal.info << "Loaded " << count << " records from " <<
+            m_journalPath;
+
+        return validBytes;
+    }
 };
 
 //------------------------------------------------------------------------------
@@ -109,7 +705,7 @@ public:
             Scheduler& scheduler, beast::Journal journal)
     {
         return std::make_unique <MemoryBackend> (
-            keyBytes, keyValues, scheduler, journal);
+            keyBytes, keyValues, journal);
     }
 };
 
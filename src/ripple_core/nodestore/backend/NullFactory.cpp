@@ -49,6 +49,10 @@ public:
     {
     }
 
+    void remove (void const* key)
+    {
+    }
+
     void visitAll (VisitCallback& callback)
     {
     }
@@ -99,6 +99,11 @@ public:
         options.create_if_missing = true;
         options.env = env;
 
+        bool const nodeStoreProfile (keyValues["profile"].equalsIgnoreCase ("nodestore"));
+
+        if (nodeStoreProfile)
+            applyNodeStoreProfile (options);
+
         if (keyValues["cache_mb"].isEmpty())
         {
             options.block_cache = rocksdb::NewLRUCache (getConfig ().getSize (siHashNodeDBCache) * 1024 * 1024);
@@ -110,7 +115,7 @@ public:
 
         if (keyValues["filter_bits"].isEmpty())
         {
-            if (getConfig ().NODE_SIZE >= 2)
+            if (nodeStoreProfile || getConfig ().NODE_SIZE >= 2)
                 options.filter_policy = rocksdb::NewBloomFilterPolicy (10);
         }
         else if (keyValues["filter_bits"].getIntValue() != 0)
@@ -152,6 +157,82 @@ public:
                 options.max_background_flushes = highThreads;
         }
 
+        if (! keyValues["block_size"].isEmpty())
+        {
+            options.block_size = keyValues["block_size"].getIntValue();
+        }
+
+        if (! keyValues["restart_interval"].isEmpty())
+        {
+            options.block_restart_interval = keyValues["restart_interval"].getIntValue();
+        }
+
+        if (! keyValues["compaction"].isEmpty())
+        {
+            if (keyValues["compaction"].equalsIgnoreCase ("universal"))
+                options.compaction_style = rocksdb::kCompactionStyleUniversal;
+            else if (keyValues["compaction"].equalsIgnoreCase ("level"))
+                options.compaction_style = rocksdb::kCompactionStyleLevel;
+            else
+                throw std::runtime_error ("Unknown compaction style in RocksDBFactory backend");
+        }
+
+        if (! keyValues["compression"].isEmpty())
+        {
+            // Either one type for all levels, or a comma separated list
+            // giving the type for each level starting with level 0.
+            // Types other than 'none' need the library built with support.
+            beast::StringArray types;
+            types.addTokens (keyValues["compression"], ",", beast::String::empty);
+            types.trim ();
+            types.removeEmptyStrings ();
+
+            options.compression_per_level.clear ();
+            for (int i = 0; i < types.size (); ++i)
+                options.compression_per_level.push_back (
+                    parseCompression (types [i]));
+
+            if (options.compression_per_level.size () == 1)
+            {
+                options.compression = options.compression_per_level.front ();
+                options.compression_per_level.clear ();
+            }
+            else if (! options.compression_per_level.empty ())
+            {
+                std::size_t const levels (
+                    static_cast <std::size_t> (std::max (options.num_levels, 1)));
+
+                if (options.compression_per_level.size () > levels)
+                    throw std::runtime_error ("Too many compression types in RocksDBFactory backend");
+
+                // Deeper levels use the type given for the last level listed
+                while (options.compression_per_level.size () < levels)
+                    options.compression_per_level.push_back (
+                        options.compression_per_level.back ());
+            }
+        }
+
+        if (! keyValues["bytes_per_sync"].isEmpty())
+        {
+            options.bytes_per_sync = keyValues["bytes_per_sync"].getLargeIntValue();
+        }
+
+        if (! keyValues["compaction_threads"].isEmpty())
+        {
+            options.max_background_compactions = keyValues["compaction_threads"].getIntValue();
+        }
+
+        // RocksDB refuses to open a database with files above level 0
+        // using universal compaction, so one written with the default
+        // leveled compaction keeps it unless 'compaction' says otherwise.
+        if (nodeStoreProfile && keyValues["compaction"].isEmpty() &&
+            (options.compaction_style == rocksdb::kCompactionStyleUniversal) &&
+            hasLeveledFiles (options, m_name))
+        {
+            m_journal.warning << "Keeping leveled compaction for the existing database " << m_name;
+            options.compaction_style = rocksdb::kCompactionStyleLevel;
+        }
+
         rocksdb::DB* db = nullptr;
         rocksdb::Status status = rocksdb::DB::Open (options, m_name, &db);
         if (!status.ok () || !db)
@@ -164,6 +245,77 @@ public:
     {
     }
 
+    /** Settings for the keys and values stored by the NodeStore.
+
+        Keys are uniformly distributed 256-bit hashes, and each object is
+        written once and never updated or deleted, except when demoted from
+        a fast tier. Reads are almost entirely point lookups.
+    */
+    static void applyNodeStoreProfile (rocksdb::Options& options)
+    {
+        // With no overwrites there is nothing for leveled compaction to
+        // reclaim, so merge sorted runs instead of rewriting each level.
+        options.compaction_style = rocksdb::kCompactionStyleUniversal;
+        options.compaction_options_universal.size_ratio = 10;
+        options.compaction_options_universal.max_size_amplification_percent = 200;
+
+        // Random keys share no prefixes, so delta encoding saves nothing
+        // and every key can be a restart point for the in-block search.
+        options.block_size = 4 * 1024;
+        options.block_restart_interval = 1;
+
+        // Lookups are always by whole key.
+        options.whole_key_filtering = true;
+
+        // Hashes and signatures compress poorly.
+        options.compression = rocksdb::kNoCompression;
+
+        // Spread out the writes from flushes and compactions instead of
+        // letting them queue up in the page cache.
+        options.bytes_per_sync = 1024 * 1024;
+        options.max_background_compactions = 2;
+        options.level0_file_num_compaction_trigger = 4;
+    }
+
+    // Returns true if an existing database has files above level 0
+    static bool hasLeveledFiles (rocksdb::Options options, std::string const& path)
+    {
+        if (! options.env->FileExists (path + "/CURRENT"))
+            return false;
+
+        options.compaction_style = rocksdb::kCompactionStyleLevel;
+
+        rocksdb::DB* db = nullptr;
+        if (! rocksdb::DB::OpenForReadOnly (options, path, &db).ok () || ! db)
+            return false;
+
+        std::unique_ptr <rocksdb::DB> const holder (db);
+
+        for (int level = 1; level < db->NumberLevels (); ++level)
+        {
+            std::string files;
+
+            if (db->GetProperty ("rocksdb.num-files-at-level" + std::to_string (level), &files) &&
+                (files != "0"))
+                return true;
+        }
+
+        return false;
+    }
+
+    static rocksdb::CompressionType parseCompression (beast::String const& name)
+    {
+        if (name.equalsIgnoreCase ("none"))
+            return rocksdb::kNoCompression;
+        if (name.equalsIgnoreCase ("snappy"))
+            return rocksdb::kSnappyCompression;
+        if (name.equalsIgnoreCase ("zlib"))
+            return rocksdb::kZlibCompression;
+        if (name.equalsIgnoreCase ("bzip2"))
+            return rocksdb::kBZip2Compression;
+        throw std::runtime_error ("Unknown compression type in RocksDBFactory backend");
+    }
+
     std::string getName()
     {
         return m_name;
@@ -173,7 +325,11 @@ public:
 
     Status fetch (void const* key, NodeObject::Ptr* pObject)
     {
-        pObject->reset ();
+        // An object waiting in the batch isn't on disk yet
+        *pObject = m_batch.fetch (uint256::fromVoid (key));
+
+        if (*pObject != nullptr)
+            return ok;
 
         Status status (ok);
 
@@ -247,13 +403,39 @@ public:
         m_db->Write (options, &wb).ok ();
     }
 
+    void remove (void const* key)
+    {
+        m_batch.remove (uint256::fromVoid (key));
+    }
+
     void visitAll (VisitCallback& callback)
     {
-        rocksdb::ReadOptions const options;
+        uint256 const first;
+
+        visitRange (first, ~first, callback);
+    }
+
+    bool canVisitRange ()
+    {
+        return true;
+    }
+
+    void visitRange (uint256 const& first, uint256 const& last,
+        VisitCallback& callback)
+    {
+        rocksdb::ReadOptions options;
+
+        // Don't let a scan push the working set out of the block cache
+        options.fill_cache = false;
 
         std::unique_ptr <rocksdb::Iterator> it (m_db->NewIterator (options));
 
-        for (it->SeekToFirst (); it->Valid (); it->Next ())
+        rocksdb::Slice const end (reinterpret_cast <char const*> (
+            last.begin ()), m_keyBytes);
+
+        for (it->Seek (rocksdb::Slice (reinterpret_cast <char const*> (
+                first.begin ()), m_keyBytes));
+            it->Valid () && (it->key ().compare (end) <= 0); it->Next ())
         {
             if (it->key ().size () == m_keyBytes)
             {
@@ -293,6 +475,21 @@ public:
     {
         storeBatch (batch);
     }
+
+    void removeBatch (std::vector <uint256> const& keys)
+    {
+        rocksdb::WriteBatch wb;
+
+        BOOST_FOREACH (uint256 const& key, keys)
+        {
+            wb.Delete (rocksdb::Slice (
+                reinterpret_cast <char const*> (key.begin ()), m_keyBytes));
+        }
+
+        rocksdb::WriteOptions const options;
+
+        m_db->Write (options, &wb).ok ();
+    }
 };
 
 //------------------------------------------------------------------------------
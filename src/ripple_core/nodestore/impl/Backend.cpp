@@ -24,5 +24,102 @@ Backend::~Backend ()
 {
 }
 
+void Backend::visitRange (uint256 const& first, uint256 const& last,
+    VisitCallback& callback)
+{
+    struct RangeCallback : VisitCallback
+    {
+        uint256 const& first;
+        uint256 const& last;
+        VisitCallback& callback;
+
+        RangeCallback (uint256 const& first_, uint256 const& last_,
+            VisitCallback& callback_)
+            : first (first_)
+            , last (last_)
+            , callback (callback_)
+        {
+        }
+
+        void visitObject (NodeObject::Ptr const& object)
+        {
+            if ((object->getHash () >= first) && (object->getHash () <= last))
+                callback.visitObject (object);
+        }
+    };
+
+    RangeCallback rangeCallback (first, last, callback);
+
+    visitAll (rangeCallback);
+}
+
+void Backend::visitParallel (VisitCallback& callback, int threadCount)
+{
+    // Scanning everything once per thread would be no faster, and
+    // visitAll must not be called concurrently with itself.
+    if (! canVisitRange () || threadCount <= 1)
+    {
+        visitAll (callback);
+        return;
+    }
+
+    std::vector <std::thread> threads;
+    std::vector <std::exception_ptr> errors (threadCount);
+
+    threads.reserve (threadCount);
+
+    // The ranges are divided on the leading 32 bits of the key
+    std::uint64_t const span (std::uint64_t (1) << 32);
+
+    // If a thread can't be started, the ones already running must be
+    // joined before unwinding, or destroying them would terminate.
+    try
+    {
+        for (int i = 0; i < threadCount; ++i)
+        {
+            std::uint32_t const low (static_cast <std::uint32_t> (
+                (span * i) / threadCount));
+            std::uint32_t const high (static_cast <std::uint32_t> (
+                ((span * (i + 1)) / threadCount) - 1));
+
+            uint256 first;
+            uint256 last (~first);
+
+            for (int j = 0; j < 4; ++j)
+            {
+                first.begin () [j] = static_cast <unsigned char> (low >> (24 - 8 * j));
+                last.begin () [j] = static_cast <unsigned char> (high >> (24 - 8 * j));
+            }
+
+            threads.emplace_back ([this, first, last, &callback, &errors, i]
+            {
+                try
+                {
+                    visitRange (first, last, callback);
+                }
+                catch (...)
+                {
+                    errors [i] = std::current_exception ();
+                }
+            });
+        }
+    }
+    catch (...)
+    {
+        for (auto& thread : threads)
+            thread.join ();
+        throw;
+    }
+
+    for (auto& thread : threads)
+        thread.join ();
+
+    for (auto const& error : errors)
+    {
+        if (error)
+            std::rethrow_exception (error);
+    }
+}
+
 }
 }
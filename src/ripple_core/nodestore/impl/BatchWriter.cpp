@@ -25,6 +25,9 @@ BatchWriter::BatchWriter (Callback& callback, Scheduler& scheduler)
     , m_scheduler (scheduler)
     , mWriteLoad (0)
     , mWritePending (false)
+    , mWriting (false)
+    , mWriteBytes (0)
+    , mWaitExpired (false)
 {
     mWriteSet.reserve (batchWritePreallocationSize);
 }
@@ -36,9 +39,51 @@ BatchWriter::~BatchWriter ()
 
 void BatchWriter::store (NodeObject::ref object)
 {
-    std::lock_guard<decltype(mWriteMutex)> sl (mWriteMutex);
+    std::unique_lock<decltype(mWriteMutex)> sl (mWriteMutex);
+
+    // Only wait while the writer is running, since a write which is
+    // merely scheduled may be queued behind the thread calling us.
+    //
+    // The wait is bounded because the consensus code stores with the master
+    // lock held. Once a wait times out, stores go over the limit without
+    // waiting until the writer takes the next batch.
+    if (mWriting && ! mWaitExpired && (mWriteBytes >= batchWriteLimitBytes))
+    {
+        std::chrono::steady_clock::time_point const deadline (
+            std::chrono::steady_clock::now () +
+                std::chrono::milliseconds (batchWriteWaitMillis));
+
+        while (mWriting && ! mWaitExpired && (mWriteBytes >= batchWriteLimitBytes))
+        {
+            if (mWriteCondition.wait_until (sl, deadline) == std::cv_status::timeout)
+            {
+                mWaitExpired = true;
+                mWriteCondition.notify_all ();
+            }
+        }
+    }
 
     mWriteSet.push_back (object);
+    mWriteBytes += object->getData ().size ();
+    mPending [object->getHash ()] = object;
+
+    // Storing an object again undoes an earlier removal
+    mRemoveSet.erase (object->getHash ());
+
+    if (! mWritePending)
+    {
+        mWritePending = true;
+
+        m_scheduler.scheduleTask (*this);
+    }
+}
+
+void BatchWriter::remove (uint256 const& hash)
+{
+    std::lock_guard<decltype(mWriteMutex)> sl (mWriteMutex);
+
+    mPending.erase (hash);
+    mRemoveSet.insert (hash);
 
     if (! mWritePending)
     {
@@ -48,6 +93,18 @@ void BatchWriter::store (NodeObject::ref object)
     }
 }
 
+NodeObject::Ptr BatchWriter::fetch (uint256 const& hash)
+{
+    std::lock_guard<decltype(mWriteMutex)> sl (mWriteMutex);
+
+    auto const iter (mPending.find (hash));
+
+    if (iter != mPending.end ())
+        return iter->second;
+
+    return NodeObject::Ptr ();
+}
+
 int BatchWriter::getWriteLoad ()
 {
     std::lock_guard<decltype(mWriteMutex)> sl (mWriteMutex);
@@ -65,6 +122,7 @@ void BatchWriter::writeBatch ()
     for (;;)
     {
         std::vector< boost::shared_ptr<NodeObject> > set;
+        std::vector <uint256> removed;
 
         set.reserve (batchWritePreallocationSize);
 
@@ -74,19 +132,67 @@ void BatchWriter::writeBatch ()
             mWriteSet.swap (set);
             assert (mWriteSet.empty ());
             mWriteLoad = set.size ();
+            mWriteBytes = 0;
+            mWaitExpired = false;
 
-            if (set.empty ())
+            if (! mRemoveSet.empty ())
+            {
+                // Objects removed since they were stored are not written
+                set.erase (std::remove_if (set.begin (), set.end (),
+                    [this](NodeObject::ref object)
+                    {
+                        return mRemoveSet.count (object->getHash ()) != 0;
+                    }), set.end ());
+
+                removed.assign (mRemoveSet.begin (), mRemoveSet.end ());
+                mRemoveSet.clear ();
+            }
+
+            if (set.empty () && removed.empty ())
             {
                 mWritePending = false;
+                mWriting = false;
                 mWriteCondition.notify_all ();
 
                 // VFALCO NOTE Fix this function to not return from the middle
                 return;
             }
 
+            mWriting = true;
+            mWriteCondition.notify_all ();
+        }
+
+        std::chrono::steady_clock::time_point const before (
+            std::chrono::steady_clock::now ());
+
+        if (! set.empty ())
+            m_callback.writeBatch (set);
+
+        // Any batch which wrote these objects has completed by now
+        if (! removed.empty ())
+            m_callback.removeBatch (removed);
+
+        BatchWriteReport report;
+        report.elapsed = std::chrono::duration_cast <std::chrono::milliseconds> (
+            std::chrono::steady_clock::now () - before);
+        report.writeCount = set.size ();
+
+        {
+            std::lock_guard<decltype(mWriteMutex)> sl (mWriteMutex);
+
+            // The objects are in the backend now. An object stored again
+            // while this batch was written stays pending until its own write.
+            BOOST_FOREACH (NodeObject::ref object, set)
+            {
+                auto const iter (mPending.find (object->getHash ()));
+                if (iter != mPending.end () && iter->second == object)
+                    mPending.erase (iter);
+            }
+
+            report.pendingCount = mWriteSet.size ();
         }
 
-        m_callback.writeBatch (set);
+        m_scheduler.onBatchWrite (report);
     }
 }
 
@@ -20,8 +20,10 @@
 #ifndef RIPPLE_NODESTORE_BATCHWRITER_H_INCLUDED
 #define RIPPLE_NODESTORE_BATCHWRITER_H_INCLUDED
 
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
+#include <unordered_set>
 
 namespace ripple {
 namespace NodeStore {
@@ -32,6 +34,15 @@ namespace NodeStore {
     class it not required. A backend can implement its own write batching,
     or skip write batching if doing so yields a performance benefit.
 
+    Objects remain visible through @ref fetch from the time they are stored
+    until the backend has written them, so a backend using this class can
+    satisfy reads of recently stored objects without touching the disk.
+
+    The amount of object data waiting to be written is bounded. When the
+    bound is exceeded while a batch is being written, @ref store blocks
+    until the writer catches up, which pushes back on whoever is producing
+    the objects.
+
     @see Scheduler
 */
 // VFALCO NOTE I'm not entirely happy having placed this here,
@@ -45,6 +56,9 @@ public:
     struct Callback
     {
         virtual void writeBatch (Batch const& batch) = 0;
+
+        /** Remove objects, after any batch which wrote them. */
+        virtual void removeBatch (std::vector <uint256> const& keys) = 0;
     };
 
     /** Create a batch writer. */
@@ -59,10 +73,25 @@ public:
     /** Store the object.
 
         This will add to the batch and initiate a scheduled task to
-        write the batch out.
+        write the batch out. If too much data is already waiting while
+        a write is in progress, this blocks until the write completes,
+        for at most batchWriteWaitMillis.
     */
     void store (NodeObject::Ptr const& object);
 
+    /** Remove the object.
+
+        A pending write of the object is dropped, and the removal is
+        handed to the callback once any batch already being written has
+        completed, so the object cannot reappear afterwards.
+    */
+    void remove (uint256 const& hash);
+
+    /** Retrieve an object which is waiting to be written.
+        @return The object, or nullptr if it is not pending.
+    */
+    NodeObject::Ptr fetch (uint256 const& hash);
+
     /** Get an estimate of the amount of writing I/O pending. */
     int getWriteLoad ();
 
@@ -81,7 +110,17 @@ private:
     CondvarType mWriteCondition;
     int mWriteLoad;
     bool mWritePending;
+    bool mWriting;
+    std::size_t mWriteBytes;
+    bool mWaitExpired;
     Batch mWriteSet;
+
+    // Objects stored but not yet written, including those in the
+    // batch the backend is currently writing.
+    ripple::unordered_map <uint256, NodeObject::Ptr> mPending;
+
+    // Objects to remove once the batch being written, if any, completes.
+    std::unordered_set <uint256, beast::hardened_hash <uint256>> mRemoveSet;
 };
 
 }
@@ -22,6 +22,7 @@
 
 #include "../../beast/beast/threads/Thread.h"
 
+#include <atomic>
 #include <thread>
 #include <condition_variable>
 
@@ -39,6 +40,10 @@ public:
     std::unique_ptr <Backend> m_backend;
     // Larger key/value storage, but not necessarily persistent.
     std::unique_ptr <Backend> m_fastBackend;
+    // Decides what lives in the fast backend
+    FastTier m_fastTier;
+    // Set once the fast tier knows what the fast backend already holds
+    std::atomic <bool> m_fastTierSeeded;
 
     // Positive cache
     TaggedCache <uint256, NodeObject> m_cache;
@@ -55,22 +60,34 @@ public:
     bool                      m_readShut;
     uint64_t                  m_readGen;        // current read generation
 
+    // Backend reads satisfied by each tier, and reads satisfied by neither
+    std::atomic <std::uint64_t> m_fastHits;
+    std::atomic <std::uint64_t> m_slowHits;
+    std::atomic <std::uint64_t> m_backendMisses;
+
     DatabaseImp (std::string const& name,
                  Scheduler& scheduler,
                  int readThreads,
                  std::unique_ptr <Backend> backend,
                  std::unique_ptr <Backend> fastBackend,
+                 std::size_t fastTierSize,
+                 int fastTierAdmitCount,
                  beast::Journal journal)
         : m_journal (journal)
         , m_scheduler (scheduler)
         , m_backend (std::move (backend))
         , m_fastBackend (std::move (fastBackend))
+        , m_fastTier (fastTierSize, fastTierAdmitCount)
+        , m_fastTierSeeded (false)
         , m_cache ("NodeStore", cacheTargetSize, cacheTargetSeconds,
             get_seconds_clock (), LogPartition::getJournal <TaggedCacheLog> ())
         , m_negCache ("NodeStore", get_seconds_clock (),
             cacheTargetSize, cacheTargetSeconds)
         , m_readShut (false)
         , m_readGen (0)
+        , m_fastHits (0)
+        , m_slowHits (0)
+        , m_backendMisses (0)
     {
         for (int i = 0; i < readThreads; ++i)
             m_readThreads.push_back (std::thread (&DatabaseImp::threadEntry, this));
@@ -158,7 +175,11 @@ public:
 
             // If we found the object, avoid storing it again later.
             if (obj != nullptr)
+            {
                 foundInFastBackend = true;
+                ++m_fastHits;
+                m_fastTier.touch (hash);
+            }
         }
 
         // Are we still without an object?
@@ -168,10 +189,15 @@ public:
             // Yes so at last we will try the main database.
             //
             obj = fetchInternal (*m_backend, hash);
+
+            if (obj != nullptr)
+                ++m_slowHits;
         }
 
         if (obj == nullptr)
         {
+            ++m_backendMisses;
+
 
             // Just in case a write occurred
             obj = m_cache.fetch (hash);
@@ -190,10 +216,14 @@ public:
 
             if (! foundInFastBackend)
             {
-                 // If we have a fast back end, store it there for later.
+                // If we have a fast back end and the object has been
+                // requested often enough, store it there for later.
                 //
-                if (m_fastBackend != nullptr)
+                if (m_fastBackend != nullptr && m_fastTier.admit (hash))
+                {
                     m_fastBackend->store (obj);
+                    m_fastTier.stored (hash);
+                }
 
                 // Since this was a 'hard' fetch, we will log it.
                 //
@@ -250,7 +280,8 @@ public:
 
         m_negCache.erase (hash);
 
-        if (m_fastBackend)
+        // A bounded fast tier only takes objects that prove to be popular.
+        if (m_fastBackend && ! m_fastTier.isBounded ())
             m_fastBackend->store (object);
     }
 
@@ -261,6 +292,14 @@ public:
         return m_cache.getHitRate ();
     }
 
+    void getTierStats (TierStats& stats)
+    {
+        stats.fastHits = m_fastHits.load ();
+        stats.slowHits = m_slowHits.load ();
+        stats.misses = m_backendMisses.load ();
+        stats.fastSize = m_fastTier.size ();
+    }
+
     void tune (int size, int age)
     {
         m_cache.setTargetSize (size);
@@ -273,6 +312,62 @@ public:
     {
         m_cache.sweep ();
         m_negCache.sweep ();
+
+        if (m_fastBackend != nullptr)
+        {
+            // A persistent fast backend may hold objects from an earlier
+            // run, which a bounded tier has to know about in order to
+            // demote them. Scanning for them here rather than when opening
+            // keeps the scan off the startup path.
+            if (m_fastTier.isBounded () && ! m_fastTierSeeded.exchange (true))
+                seedFastTier ();
+
+            demote ();
+        }
+    }
+
+    // Track the objects already in the fast backend as resident. Objects
+    // stored since opening may be visited too, which only refreshes them.
+    void seedFastTier ()
+    {
+        class SeedVisitCallback : public VisitCallback
+        {
+        public:
+            explicit SeedVisitCallback (FastTier& fastTier)
+                : m_fastTier (fastTier)
+            {
+            }
+
+            void visitObject (NodeObject::Ptr const& object)
+            {
+                m_fastTier.stored (object->getHash ());
+            }
+
+        private:
+            FastTier& m_fastTier;
+        };
+
+        SeedVisitCallback callback (m_fastTier);
+
+        m_fastBackend->visitAll (callback);
+
+        if (m_journal.debug) m_journal.debug <<
+            "Found " << m_fastTier.size () << " objects in the fast backend";
+    }
+
+    // Remove the least recently used objects in excess of the fast tier
+    // size. Every object is also in the persistent backend, so a demoted
+    // object is simply read from there the next time it is needed.
+    void demote ()
+    {
+        std::vector <uint256> keys;
+        m_fastTier.evict (keys);
+
+        BOOST_FOREACH (uint256 const& hash, keys)
+            m_fastBackend->remove (hash.begin ());
+
+        if (! keys.empty () && m_journal.debug) m_journal.debug <<
+            "Demoted " << keys.size () << " objects from the fast backend";
     }
 
     int getWriteLoad ()
@@ -34,6 +34,10 @@ void DummyScheduler::scheduleTask (Task& task)
     task.performScheduledTask();
 }
 
+void DummyScheduler::onBatchWrite (BatchWriteReport const& report)
+{
+}
+
 void DummyScheduler::scheduledTasksStopped ()
 {
 }
@@ -0,0 +1,193 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_FASTTIER_H_INCLUDED
+#define RIPPLE_NODESTORE_FASTTIER_H_INCLUDED
+
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** Placement policy for the fast backend of a two-tier Database.
+
+    When unbounded, every object read from the persistent backend is
+    admitted into the fast backend and nothing is ever removed, which
+    is the historical behavior.
+
+    When bounded, an object read from the persistent backend is admitted
+    only after it has been requested a configurable number of times.
+    Access counts are halved whenever the table of counts grows past twice
+    the tier size, so that stale popularity decays. Resident keys are kept in
+    least recently used order, and the excess is handed back by @ref evict
+    so the caller can remove it from the fast backend.
+
+    Keys already present in the fast backend when the Database is opened
+    are passed to @ref stored, so they are demoted like any other.
+
+    Thread safety:
+        Safe to call from any thread.
+*/
+class FastTier
+{
+public:
+    /** Create the policy.
+        @param targetSize The maximum number of resident objects,
+                          or zero for an unbounded tier.
+        @param admitCount The number of requests before admission.
+    */
+    FastTier (std::size_t targetSize, int admitCount)
+        : m_targetSize (targetSize)
+        , m_admitCount (std::max (admitCount, 1))
+    {
+    }
+
+    bool isBounded () const
+    {
+        return m_targetSize != 0;
+    }
+
+    /** Called when an object was read from the persistent backend.
+        The object is not tracked until @ref stored is called.
+        @return `true` if the object should be stored in the fast backend.
+    */
+    bool admit (uint256 const& hash)
+    {
+        if (! isBounded ())
+            return true;
+
+        std::lock_guard <std::mutex> lock (m_mutex);
+
+        if (m_resident.find (hash) != m_resident.end ())
+            return false;
+
+        int& count (m_counts [hash]);
+
+        if (++count < m_admitCount)
+        {
+            if (m_counts.size () > 2 * m_targetSize)
+                age ();
+            return false;
+        }
+
+        m_counts.erase (hash);
+        return true;
+    }
+
+    /** Called once an admitted object was given to the fast backend.
+        The write may still be pending. Backend::remove drops a pending
+        write, so evicting the object before it is written is safe.
+    */
+    void stored (uint256 const& hash)
+    {
+        if (! isBounded ())
+            return;
+
+        std::lock_guard <std::mutex> lock (m_mutex);
+
+        map_type::iterator const iter (m_resident.find (hash));
+
+        if (iter != m_resident.end ())
+        {
+            m_lru.splice (m_lru.begin (), m_lru, iter->second);
+            return;
+        }
+
+        m_lru.push_front (hash);
+        m_resident.emplace (hash, m_lru.begin ());
+    }
+
+    /** Called when an object was read from the fast backend. */
+    void touch (uint256 const& hash)
+    {
+        if (! isBounded ())
+            return;
+
+        std::lock_guard <std::mutex> lock (m_mutex);
+
+        map_type::iterator const iter (m_resident.find (hash));
+
+        if (iter != m_resident.end ())
+            m_lru.splice (m_lru.begin (), m_lru, iter->second);
+    }
+
+    /** Retrieve the least recently used keys in excess of the target size.
+        The keys are no longer tracked as resident when this returns.
+    */
+    void evict (std::vector <uint256>& keys)
+    {
+        if (! isBounded ())
+            return;
+
+        std::lock_guard <std::mutex> lock (m_mutex);
+
+        while (m_resident.size () > m_targetSize)
+        {
+            uint256 const& hash (m_lru.back ());
+            keys.push_back (hash);
+            m_resident.erase (hash);
+            m_lru.pop_back ();
+        }
+    }
+
+    /** Returns the number of objects known to be in the fast backend. */
+    std::size_t size () const
+    {
+        std::lock_guard <std::mutex> lock (m_mutex);
+        return m_resident.size ();
+    }
+
+private:
+    typedef std::list <uint256> list_type;
+    typedef ripple::unordered_map <uint256,
+        list_type::iterator> map_type;
+    typedef ripple::unordered_map <uint256, int> count_map;
+
+    // Halve every access count, forgetting keys that reach zero
+    void age ()
+    {
+        count_map::iterator iter (m_counts.begin ());
+
+        while (iter != m_counts.end ())
+        {
+            iter->second /= 2;
+
+            if (iter->second == 0)
+                iter = m_counts.erase (iter);
+            else
+                ++iter;
+        }
+    }
+
+    std::size_t const m_targetSize;
+    int const m_admitCount;
+
+    std::mutex mutable m_mutex;
+    list_type m_lru;
+    map_type m_resident;
+    count_map m_counts;
+};
+
+}
+}
+
+#endif
@@ -121,8 +121,19 @@ public:
                 ? make_Backend (fastBackendParameters, scheduler, journal)
                 : nullptr);
 
+        // An optional bound on the number of objects in the fast backend
+        std::size_t fastTierSize (0);
+        if (! fastBackendParameters ["tier_size"].isEmpty ())
+            fastTierSize = std::max (0,
+                fastBackendParameters ["tier_size"].getIntValue ());
+
+        int fastTierAdmit (fastTierAdmitCount);
+        if (! fastBackendParameters ["tier_admit"].isEmpty ())
+            fastTierAdmit = fastBackendParameters ["tier_admit"].getIntValue ();
+
         return std::make_unique <DatabaseImp> (name, scheduler, readThreads,
-            std::move (backend), std::move (fastBackend), journal);
+            std::move (backend), std::move (fastBackend), fastTierSize,
+                fastTierAdmit, journal);
     }
 };
 
@@ -30,6 +30,17 @@ enum
 
     // Expiration time for cached nodes
     ,cacheTargetSeconds = 300
+
+    // Number of requests before an object is placed in a bounded fast backend
+    ,fastTierAdmitCount = 2
+
+    // Bytes of object data that may wait for a batch write before
+    // callers storing objects are made to wait for the writer
+    ,batchWriteLimitBytes = 64 * 1024 * 1024
+
+    // Longest time in milliseconds that callers storing objects wait for
+    // each batch write. Callers may hold the master lock.
+    ,batchWriteWaitMillis = 100
 };
 
 }
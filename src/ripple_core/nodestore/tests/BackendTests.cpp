@@ -41,6 +41,10 @@ public:
         params.set ("type", type);
         params.set ("path", path.getFullPathName ());
 
+        // The memory backend only persists through its journal
+        if (type == "memory")
+            params.set ("journal", path.getFullPathName ());
+
         // Create a batch
         Batch batch;
         createPredictableBatch (batch, 0, numObjectsToTest, seedValue);
@@ -83,7 +87,209 @@ public:
             std::sort (batch.begin (), batch.end (), NodeObject::LessThan ());
             std::sort (copy.begin (), copy.end (), NodeObject::LessThan ());
             expect (areBatchesEqual (batch, copy), "Should be equal");
+
+            // Scan disjoint ranges in parallel
+            CountingCallback callback;
+            backend->visitParallel (callback, 4);
+            expect (callback.count == batch.size (), "Should visit each object once");
         }
+
+        // Removes the memory backend's journal
+        path.deleteFile ();
+    }
+
+    // Returns `true` if the backend holds the object
+    bool contains (Backend& backend, NodeObject::ref object)
+    {
+        NodeObject::Ptr copy;
+        backend.fetch (object->getHash ().cbegin (), &copy);
+        return copy != nullptr;
+    }
+
+    // Removal must win over a write still waiting in the batch
+    void testRemove (beast::String type, std::int64_t const seedValue)
+    {
+        std::unique_ptr <Manager> manager (make_Manager ());
+
+        DeferredScheduler scheduler;
+
+        testcase ((beast::String ("remove type=") + type).toStdString());
+
+        beast::StringPairArray params;
+        beast::File const path (beast::File::createTempFile ("node_db"));
+        params.set ("type", type);
+        params.set ("path", path.getFullPathName ());
+
+        Batch batch;
+        createPredictableBatch (batch, 0, 100, seedValue);
+
+        Batch written (batch.begin (), batch.begin () + 50);
+        Batch pending (batch.begin () + 50, batch.end ());
+
+        beast::Journal j;
+
+        {
+            std::unique_ptr <Backend> backend (manager->make_Backend (
+                params, scheduler, j));
+
+            storeBatch (*backend, written);
+            scheduler.runTasks ();
+
+            // These writes stay in the batch until the tasks run again
+            storeBatch (*backend, pending);
+
+            for (int i = 0; i < 25; ++i)
+            {
+                backend->remove (written [i]->getHash ().cbegin ());
+                backend->remove (pending [i]->getHash ().cbegin ());
+            }
+
+            for (int i = 0; i < 25; ++i)
+            {
+                expect (! contains (*backend, written [i]), "Should be removed");
+                expect (! contains (*backend, pending [i]), "Should be removed");
+            }
+            for (int i = 25; i < pending.size (); ++i)
+                expect (contains (*backend, pending [i]), "Should be pending");
+
+            scheduler.runTasks ();
+
+            for (int i = 0; i < 25; ++i)
+            {
+                expect (! contains (*backend, written [i]), "Should stay removed");
+                expect (! contains (*backend, pending [i]), "Should not be written");
+            }
+        }
+
+        {
+            DummyScheduler syncScheduler;
+
+            std::unique_ptr <Backend> backend (manager->make_Backend (
+                params, syncScheduler, j));
+
+            for (int i = 0; i < 25; ++i)
+            {
+                expect (! contains (*backend, written [i]), "Should stay removed");
+                expect (! contains (*backend, pending [i]), "Should stay removed");
+            }
+            for (int i = 25; i < 50; ++i)
+            {
+                expect (contains (*backend, written [i]), "Should be present");
+                expect (contains (*backend, pending [i]), "Should be present");
+            }
+        }
+
+        path.deleteRecursively ();
+    }
+
+    void testMemoryJournal (std::int64_t const seedValue)
+    {
+        std::unique_ptr <Manager> manager (make_Manager ());
+
+        DummyScheduler scheduler;
+
+        testcase ("memory journal");
+
+        beast::File const path (beast::File::createTempFile ("node_journal"));
+        beast::StringPairArray params;
+        params.set ("type", "memory");
+        params.set ("journal", path.getFullPathName ());
+
+        Batch batch;
+        createPredictableBatch (batch, 0, 100, seedValue);
+
+        beast::Journal j;
+
+        // Removals are replayed after the objects they remove
+        {
+            std::unique_ptr <Backend> backend (manager->make_Backend (
+                params, scheduler, j));
+
+            storeBatch (*backend, batch);
+
+            for (int i = 0; i < 50; ++i)
+                backend->remove (batch [i]->getHash ().cbegin ());
+
+            // Storing again after a removal brings the object back
+            backend->store (batch [0]);
+        }
+
+        std::int64_t const validBytes (path.getSize ());
+
+        // Append a torn record, as a crash in the middle of a write would
+        {
+            std::ofstream stream (path.getFullPathName ().toStdString ().c_str (),
+                std::ios::out | std::ios::binary | std::ios::app);
+            stream.write ("\0\0\1\0torn", 8);
+        }
+
+        {
+            std::unique_ptr <Backend> backend (manager->make_Backend (
+                params, scheduler, j));
+
+            expect (path.getSize () == validBytes, "Should truncate the torn record");
+
+            expect (contains (*backend, batch [0]), "Should be stored again");
+            for (int i = 1; i < 50; ++i)
+                expect (! contains (*backend, batch [i]), "Should be removed");
+            for (int i = 50; i < batch.size (); ++i)
+                expect (contains (*backend, batch [i]), "Should be present");
+
+            // Records written after the truncation are read back
+            backend->remove (batch [50]->getHash ().cbegin ());
+        }
+
+        {
+            std::unique_ptr <Backend> backend (manager->make_Backend (
+                params, scheduler, j));
+
+            expect (! contains (*backend, batch [50]), "Should be removed");
+            expect (contains (*backend, batch [51]), "Should be present");
+        }
+
+        std::int64_t const loadedBytes (path.getSize ());
+
+        // Append a record with a damaged size and a complete key
+        {
+            std::ofstream stream (path.getFullPathName ().toStdString ().c_str (),
+                std::ios::out | std::ios::binary | std::ios::app);
+            stream.write ("\xff\xff\xff\xf0", 4);
+            stream << std::string (64, 'x');
+        }
+
+        {
+            std::unique_ptr <Backend> backend (manager->make_Backend (
+                params, scheduler, j));
+
+            expect (path.getSize () == loadedBytes, "Should truncate the damaged record");
+            expect (contains (*backend, batch [51]), "Should be present");
+        }
+
+        // An object too large for the journal is refused, not kept in memory
+        {
+            std::unique_ptr <Backend> backend (manager->make_Backend (
+                params, scheduler, j));
+
+            Blob data (16 * 1024 * 1024);
+            NodeObject::Ptr const object (NodeObject::createObject (
+                hotUNKNOWN, 0, data, uint256 (std::uint64_t (1))));
+
+            bool refused (false);
+
+            try
+            {
+                backend->store (object);
+            }
+            catch (std::runtime_error const&)
+            {
+                refused = true;
+            }
+
+            expect (refused, "Should refuse an oversized object");
+            expect (! contains (*backend, object), "Should not hold an oversized object");
+        }
+
+        path.deleteFile ();
     }
 
     //--------------------------------------------------------------------------
@@ -94,6 +300,12 @@ public:
 
         testBackend ("leveldb", seedValue);
 
+        testRemove ("leveldb", seedValue);
+
+        testBackend ("memory", seedValue);
+
+        testMemoryJournal (seedValue);
+
     #ifdef RIPPLE_ENABLE_SQLITE_BACKEND_TESTS
         testBackend ("sqlite", seedValue);
     #endif
@@ -20,7 +20,7 @@
 namespace ripple {
 namespace NodeStore {
 
-// Tests predictable batches, and NodeObject blob encoding
+// Tests predictable batches, NodeObject blob encoding, and fast tier placement
 //
 class NodeStoreBasic_test : public TestBase
 {
@@ -70,6 +70,54 @@ public:
         }
     }
 
+    // Checks admission and demotion in a bounded fast tier
+    void testFastTier (std::int64_t const seedValue)
+    {
+        testcase ("fast tier");
+
+        Batch batch;
+        createPredictableBatch (batch, 0, 4, seedValue);
+
+        {
+            FastTier tier (0, 2);
+            expect (tier.admit (batch [0]->getHash ()), "Should admit");
+            expect (tier.size () == 0, "Should not track");
+        }
+
+        FastTier tier (2, 2);
+
+        // Objects are admitted on the second request
+        for (int i = 0; i < batch.size (); ++i)
+            expect (! tier.admit (batch [i]->getHash ()), "Should not admit");
+        for (int i = 0; i < batch.size (); ++i)
+            expect (tier.admit (batch [i]->getHash ()), "Should admit");
+
+        // Nothing can be evicted until it has been stored
+        {
+            std::vector <uint256> keys;
+            tier.evict (keys);
+            expect (keys.empty () && tier.size () == 0, "Should not track");
+        }
+
+        for (int i = 0; i < batch.size (); ++i)
+            tier.stored (batch [i]->getHash ());
+        expect (! tier.admit (batch [0]->getHash ()), "Already resident");
+        expect (tier.size () == 4, "Should track");
+
+        // The least recently used objects are evicted first
+        tier.touch (batch [0]->getHash ());
+        tier.touch (batch [1]->getHash ());
+
+        std::vector <uint256> keys;
+        tier.evict (keys);
+        expect (tier.size () == 2, "Should shrink");
+        expect (keys.size () == 2, "Should evict");
+        expect (std::find (keys.begin (), keys.end (),
+            batch [0]->getHash ()) == keys.end (), "Should keep");
+        expect (std::find (keys.begin (), keys.end (),
+            batch [1]->getHash ()) == keys.end (), "Should keep");
+    }
+
     void run ()
     {
         std::int64_t const seedValue = 50;
@@ -77,6 +125,8 @@ public:
         testBatches (seedValue);
 
         testBlobs (seedValue);
+
+        testFastTier (seedValue);
     }
 };
 
@@ -177,6 +177,72 @@ public:
 
     //--------------------------------------------------------------------------
 
+    // Objects left in a bounded fast backend by an earlier run must be
+    // demoted like the ones stored since the database was opened.
+    void testFastTierReopen (beast::String type, std::int64_t const seedValue)
+    {
+        std::unique_ptr <Manager> manager (make_Manager ());
+
+        DummyScheduler scheduler;
+
+        testcase ((beast::String ("fast tier reopen type=") + type).toStdString());
+
+        beast::File const node_db (beast::File::createTempFile ("node_db"));
+        beast::StringPairArray nodeParams;
+        nodeParams.set ("type", type);
+        nodeParams.set ("path", node_db.getFullPathName ());
+
+        beast::File const temp_db (beast::File::createTempFile ("temp_db"));
+        beast::StringPairArray tempParams;
+        tempParams.set ("type", type);
+        tempParams.set ("path", temp_db.getFullPathName ());
+
+        Batch batch;
+        createPredictableBatch (batch, 0, 100, seedValue);
+
+        beast::Journal j;
+
+        {
+            // Fill the fast backend as an earlier, unbounded run would
+            std::unique_ptr <Database> db (manager->make_Database (
+                "test", scheduler, j, 2, tempParams));
+            storeBatch (*db, batch);
+        }
+
+        {
+            beast::StringPairArray boundedParams (tempParams);
+            boundedParams.set ("tier_size", "10");
+
+            std::unique_ptr <Database> db (manager->make_Database ("test",
+                scheduler, j, 2, nodeParams, boundedParams));
+
+            // The existing objects are found by the first sweep,
+            // not while opening
+            Database::TierStats stats;
+            db->getTierStats (stats);
+            expect (stats.fastSize == 0, "Should not scan when opened");
+
+            db->sweep ();
+
+            db->getTierStats (stats);
+            expect (stats.fastSize == 10, "Should demote existing objects");
+        }
+
+        {
+            std::unique_ptr <Database> db (manager->make_Database (
+                "test", scheduler, j, 2, tempParams));
+
+            CountingCallback callback;
+            db->visitAll (callback);
+            expect (callback.count == 10, "Should remove demoted objects");
+        }
+
+        node_db.deleteRecursively ();
+        temp_db.deleteRecursively ();
+    }
+
+    //--------------------------------------------------------------------------
+
     void runBackendTests (bool useEphemeralDatabase, std::int64_t const seedValue)
     {
         testNodeStore ("leveldb", useEphemeralDatabase, true, seedValue);
@@ -226,6 +292,8 @@ public:
         runBackendTests (true, seedValue);
 
         runImportTests (seedValue);
+
+        testFastTierReopen ("leveldb", seedValue);
     }
 };
 
@@ -82,6 +82,53 @@ public:
         std::int64_t const m_seedValue;
     };
 
+    // Counts the objects visited, which may be on several threads
+    struct CountingCallback : VisitCallback
+    {
+        std::atomic <std::size_t> count;
+
+        CountingCallback ()
+            : count (0)
+        {
+        }
+
+        void visitObject (NodeObject::Ptr const&)
+        {
+            ++count;
+        }
+    };
+
+    // Holds scheduled tasks until told to run them, so a test can act
+    // while a batch write is still pending.
+    class DeferredScheduler : public Scheduler
+    {
+    public:
+        void scheduleTask (Task& task)
+        {
+            m_tasks.push_back (&task);
+        }
+
+        void onBatchWrite (BatchWriteReport const&)
+        {
+        }
+
+        // Run the tasks scheduled so far, and any they schedule
+        void runTasks ()
+        {
+            while (! m_tasks.empty ())
+            {
+                std::vector <Task*> tasks;
+                tasks.swap (m_tasks);
+
+                BOOST_FOREACH (Task* task, tasks)
+                    task->performScheduledTask ();
+            }
+        }
+
+    private:
+        std::vector <Task*> m_tasks;
+    };
+
 public:
     // Create a predictable batch of objects
     static void createPredictableBatch (Batch& batch, int startingIndex,
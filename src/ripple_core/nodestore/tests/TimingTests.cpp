@@ -51,9 +51,26 @@ public:
         std::int64_t m_startTime;
     };
 
+    // Touches each object the way a scan would
+    struct ScanCallback : VisitCallback
+    {
+        std::atomic <std::size_t> bytes;
+
+        ScanCallback ()
+            : bytes (0)
+        {
+        }
+
+        void visitObject (NodeObject::Ptr const& object)
+        {
+            bytes += object->getData ().size ();
+        }
+    };
+
     //--------------------------------------------------------------------------
 
-    void testBackend (beast::String type, std::int64_t const seedValue)
+    void testBackend (beast::String type, std::int64_t const seedValue,
+        beast::StringPairArray const& extraParams = beast::StringPairArray ())
     {
         std::unique_ptr <Manager> manager (make_Manager ());
 
@@ -61,9 +78,11 @@ public:
 
         beast::String s;
         s << "Testing backend '" << type << "' performance";
+        if (extraParams.size () > 0)
+            s << " (" << extraParams.getDescription () << ")";
         testcase (s.toStdString());
 
-        beast::StringPairArray params;
+        beast::StringPairArray params (extraParams);
         beast::File const path (beast::File::createTempFile ("node_db"));
         params.set ("type", type);
         params.set ("path", path.getFullPathName ());
@@ -104,6 +123,28 @@ public:
         s = "";
         s << "  Batch read:   " << beast::String (t.getElapsed (), 2) << " seconds";
         log << s.toStdString();
+
+        // Random point lookups, the common case for a running server
+        beast::UnitTestUtilities::repeatableShuffle (batch1.size (), batch1, seedValue);
+        t.start ();
+        fetchCopyOfBatch (*backend, &copy, batch1);
+        s = "";
+        s << "  Random read:  " << beast::String (t.getElapsed (), 2) << " seconds";
+        log << s.toStdString();
+
+        // Full scans, as used by import and offline tools
+        ScanCallback callback;
+        t.start ();
+        backend->visitAll (callback);
+        s = "";
+        s << "  Scan:         " << beast::String (t.getElapsed (), 2) << " seconds";
+        log << s.toStdString();
+
+        t.start ();
+        backend->visitParallel (callback, 4);
+        s = "";
+        s << "  4 way scan:   " << beast::String (t.getElapsed (), 2) << " seconds";
+        log << s.toStdString();
     }
 
     //--------------------------------------------------------------------------
@@ -114,12 +155,28 @@ public:
 
         testBackend ("leveldb", seedValue);
 
+        testBackend ("memory", seedValue);
+
+        {
+            beast::File const journal (beast::File::createTempFile ("node_journal"));
+            beast::StringPairArray params;
+            params.set ("journal", journal.getFullPathName ());
+            testBackend ("memory", seedValue, params);
+            journal.deleteFile ();
+        }
+
     #if RIPPLE_HYPERLEVELDB_AVAILABLE
         testBackend ("hyperleveldb", seedValue);
     #endif
 
     #if RIPPLE_ROCKSDB_AVAILABLE
         testBackend ("rocksdb", seedValue);
+
+        {
+            beast::StringPairArray params;
+            params.set ("profile", "nodestore");
+            testBackend ("rocksdb", seedValue, params);
+        }
     #endif
 
     #if RIPPLE_ENABLE_SQLITE_BACKEND_TESTS
@@ -363,6 +363,20 @@ private:
         return jvRequest;
     }
 
+    // submit_benchmark [<transactions> [<accounts>]]
+    Json::Value parseSubmitBenchmark (const Json::Value& jvParams)
+    {
+        Json::Value     jvRequest (Json::objectValue);
+
+        if (jvParams.size () >= 1)
+            jvRequest["transactions"]   = jvParams[0u].asUInt ();
+
+        if (jvParams.size () >= 2)
+            jvRequest["accounts"]       = jvParams[1u].asUInt ();
+
+        return jvRequest;
+    }
+
     // json <command> <json>
     Json::Value parseJson (const Json::Value& jvParams)
     {
@@ -830,6 +844,7 @@ public:
             {   "sign",                 &RPCParser::parseSignSubmit,            2,  3   },
             {   "sms",                  &RPCParser::parseSMS,                   1,  1   },
             {   "submit",               &RPCParser::parseSignSubmit,            1,  3   },
+            {   "submit_benchmark",     &RPCParser::parseSubmitBenchmark,       0,  2   },
             {   "server_info",          &RPCParser::parseAsIs,                  0,  0   },
             {   "server_state",         &RPCParser::parseAsIs,                  0,  0   },
             {   "stop",                 &RPCParser::parseAsIs,                  0,  0   },
@@ -52,6 +52,24 @@ protected:
 public:
     typedef std::vector <Peer::ptr> PeerSequence;
 
+    /** Counts of transactions relayed to us by peers. */
+    struct TransactionStats
+    {
+        TransactionStats ()
+            : received (0)
+            , suppressed (0)
+            , malformed (0)
+        {
+        }
+
+        // Transaction messages received
+        std::uint64_t received;
+        // Duplicates dropped before they were parsed
+        std::uint64_t suppressed;
+        // Messages which could not be parsed
+        std::uint64_t malformed;
+    };
+
     virtual ~Overlay () = default;
 
     // VFALCO NOTE These should be a private API
@@ -71,6 +89,9 @@ public:
     virtual Json::Value json () = 0;
     virtual PeerSequence getActivePeers () = 0;
 
+    /** Retrieve the relayed transaction counters. */
+    virtual void getTransactionStats (TransactionStats& stats) = 0;
+
     // Peer 64-bit ID function
     virtual Peer::ptr findPeerByShortID (Peer::ShortId const& id) = 0;
 
@@ -73,6 +73,8 @@ public:
     virtual bool hasTxSet (uint256 const& hash) const = 0;
     virtual void cycleStatus () = 0;
     virtual bool supportsVersion (int version) = 0;
+    /** Returns `true` if the peer can use set deltas in proposals. */
+    virtual bool supportsTxSetDeltas () const = 0;
     virtual bool hasRange (std::uint32_t uMin, std::uint32_t uMax) = 0;
 };
 
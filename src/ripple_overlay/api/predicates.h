@@ -151,6 +151,17 @@ struct peer_in_cluster
 
 //------------------------------------------------------------------------------
 
+/** Select all peers that accept transaction set deltas in proposals */
+struct peer_takes_set_deltas
+{
+    bool operator() (Peer::ptr const& peer) const
+    {
+        return peer->supportsTxSetDeltas ();
+    }
+};
+
+//------------------------------------------------------------------------------
+
 /** Select all peers that are in the specified set */
 struct peer_in_set
 {
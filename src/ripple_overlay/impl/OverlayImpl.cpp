@@ -98,6 +98,9 @@ OverlayImpl::OverlayImpl (Stoppable& parent,
     , m_io_service (io_service)
     , m_ssl_context (ssl_context)
     , m_resolver (resolver)
+    , m_txReceived (0)
+    , m_txSuppressed (0)
+    , m_txMalformed (0)
 {
 }
 
@@ -205,6 +208,20 @@ OverlayImpl::next_id()
     return ++m_nextShortId;
 }
 
+void
+OverlayImpl::onTransaction (bool suppressed)
+{
+    ++m_txReceived;
+    if (suppressed)
+        ++m_txSuppressed;
+}
+
+void
+OverlayImpl::onMalformedTransaction ()
+{
+    ++m_txMalformed;
+}
+
 //--------------------------------------------------------------------------
 
 // Check for the stopped condition
@@ -550,6 +567,14 @@ OverlayImpl::json ()
     return foreach (get_peer_json());
 }
 
+void
+OverlayImpl::getTransactionStats (TransactionStats& stats)
+{
+    stats.received = m_txReceived.load ();
+    stats.suppressed = m_txSuppressed.load ();
+    stats.malformed = m_txMalformed.load ();
+}
+
 Overlay::PeerSequence
 OverlayImpl::getActivePeers ()
 {
@@ -33,6 +33,7 @@
 #include <boost/unordered_map.hpp>
 
 #include "../../beast/beast/cxx14/memory.h" // <memory>
+#include <atomic>
 #include <cassert>
 #include <condition_variable>
 #include <mutex>
@@ -96,6 +97,11 @@ public:
     /** Monotically increasing identifiers for peers */
     beast::Atomic <Peer::ShortId> m_nextShortId;
 
+    /** Relayed transaction counters */
+    std::atomic <std::uint64_t> m_txReceived;
+    std::atomic <std::uint64_t> m_txSuppressed;
+    std::atomic <std::uint64_t> m_txMalformed;
+
     //--------------------------------------------------------------------------
 
     OverlayImpl (Stoppable& parent,
@@ -126,6 +132,16 @@ public:
     Peer::ShortId
     next_id();
 
+    /** Called for each transaction message a peer sends us.
+        @param suppressed `true` if it was a duplicate dropped unparsed.
+    */
+    void
+    onTransaction (bool suppressed);
+
+    /** Called when a relayed transaction could not be parsed. */
+    void
+    onMalformedTransaction ();
+
     //--------------------------------------------------------------------------
 
     void
@@ -217,6 +233,9 @@ public:
     Overlay::PeerSequence
     getActivePeers ();
 
+    void
+    getTransactionStats (TransactionStats& stats);
+
     Peer::ptr
     findPeerByShortID (Peer::ShortId const& id);
 };
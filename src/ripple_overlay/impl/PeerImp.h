@@ -637,6 +637,11 @@ public:
         return mHello.has_protoversion () && (mHello.protoversion () >= version);
     }
 
+    bool supportsTxSetDeltas () const
+    {
+        return mHello.has_txsetdeltas () && mHello.txsetdeltas ();
+    }
+
     bool hasRange (std::uint32_t uMin, std::uint32_t uMax)
     {
         return (uMin >= m_minLedger) && (uMax <= m_maxLedger);
@@ -1315,6 +1320,7 @@ private:
         h.set_nodeproof (&vchSig[0], vchSig.size ());
         h.set_ipv4port (getConfig ().peerListeningPort);
         h.set_testnet (false);
+        h.set_txsetdeltas (true);
 
         // We always advertise ourselves as private in the HELLO message. This
         // suppresses the old peer advertising code and allows PeerFinder to
@@ -1497,56 +1503,58 @@ private:
 
     void recvTransaction (protocol::TMTransaction& packet)
     {
+        std::string const& raw (packet.rawtransaction ());
 
-        Serializer s (packet.rawtransaction ());
-
-    #ifndef TRUST_NETWORK
-        try
+        if ((raw.size () < static_cast <std::size_t> (Protocol::txMinSizeBytes)) ||
+            (raw.size () > static_cast <std::size_t> (Protocol::txMaxSizeBytes)))
         {
-    #endif
-            SerializerIterator sit (s);
-            SerializedTransaction::pointer stx = boost::make_shared<SerializedTransaction> (boost::ref (sit));
-            uint256 txID = stx->getTransactionID();
+            m_journal.warning << "Transaction has invalid length: " << raw.size ();
+            m_overlay.onMalformedTransaction ();
+            return;
+        }
 
-            int flags;
+        // The transaction ID is the hash of its canonical encoding, so most
+        // duplicates can be recognized without paying to parse them.
+        uint256 const txID (Serializer::getPrefixHash (
+            HashPrefix::transactionID, raw));
 
-            if (! getApp().getHashRouter ().addSuppressionPeer (txID, m_shortId, flags))
+        int flags;
+
+        if (! getApp().getHashRouter ().addSuppressionPeer (txID, m_shortId, flags))
+        {
+            // we have seen this transaction recently
+            if (is_bit_set (flags, SF_BAD))
             {
-                // we have seen this transaction recently
-                if (is_bit_set (flags, SF_BAD))
-                {
-                    charge (Resource::feeInvalidSignature);
-                    return;
-                }
+                m_overlay.onTransaction (true);
+                charge (Resource::feeInvalidSignature);
+                return;
+            }
 
-                if (!is_bit_set (flags, SF_RETRY))
-                    return;
+            if (!is_bit_set (flags, SF_RETRY))
+            {
+                m_overlay.onTransaction (true);
+                return;
             }
+        }
 
-             m_journal.debug << "Got transaction from peer " << *this << ": " << txID;
+        m_overlay.onTransaction (false);
 
-            if (m_clusterNode)
-                flags |= SF_TRUSTED | SF_SIGGOOD;
+        m_journal.debug << "Got transaction from peer " << *this << ": " << txID;
 
-            if (getApp().getJobQueue().getJobCount(jtTRANSACTION) > 100)
-                m_journal.info << "Transaction queue is full";
-            else if (getApp().getLedgerMaster().getValidatedLedgerAge() > 240)
-                m_journal.trace << "No new transactions until synchronized";
-            else
-                getApp().getJobQueue ().addJob (jtTRANSACTION,
-                    "recvTransaction->checkTransaction",
-                    BIND_TYPE (
-                        &PeerImp::checkTransaction, P_1, flags, stx,
-                        boost::weak_ptr<Peer> (shared_from_this ())));
+        if (m_clusterNode)
+            flags |= SF_TRUSTED | SF_SIGGOOD;
 
-    #ifndef TRUST_NETWORK
-        }
-        catch (...)
-        {
-            m_journal.warning << "Transaction invalid: " <<
-               s.getHex();
-        }
-    #endif
+        if (getApp().getJobQueue().getJobCount(jtTRANSACTION) > 100)
+            m_journal.info << "Transaction queue is full";
+        else if (getApp().getLedgerMaster().getValidatedLedgerAge() > 240)
+            m_journal.trace << "No new transactions until synchronized";
+        else
+            getApp().getJobQueue ().addJob (jtTRANSACTION,
+                "recvTransaction->checkTransaction",
+                BIND_TYPE (
+                    &PeerImp::checkTransaction, P_1, &m_overlay, flags, txID,
+                    boost::make_shared <Serializer> (raw),
+                    boost::weak_ptr<Peer> (shared_from_this ())));
     }
 
     void recvValidation (const boost::shared_ptr<protocol::TMValidation>& packet)
@@ -1884,8 +1892,9 @@ private:
         if (packet.type () == protocol::liTS_CANDIDATE)
         {
             // got data for a candidate transaction set
-            std::list<SHAMapNode> nodeIDs;
+            std::vector<SHAMapNode> nodeIDs;
             std::list< Blob > nodeData;
+            nodeIDs.reserve (packet.nodes ().size ());
 
             for (int i = 0; i < packet.nodes ().size (); ++i)
             {
@@ -2057,12 +2066,74 @@ private:
             prevLedger.isNonZero () ? prevLedger : consensusLCL,
             set.proposeseq (), proposeHash, set.closetime (), signerPublic, suppression);
 
+        if (set.has_previoustxhash () || (set.addedtransactions_size () != 0) ||
+            (set.removedtransactions_size () != 0))
+            takeSetDelta (set, proposal);
+
         getApp().getJobQueue ().addJob (isTrusted ? jtPROPOSAL_t : jtPROPOSAL_ut,
             "recvPropose->checkPropose", BIND_TYPE (
                 &PeerImp::checkPropose, P_1, &m_overlay, packet, proposal, consensusLCL,
                 m_nodePublicKey, boost::weak_ptr<Peer> (shared_from_this ()), m_clusterNode));
     }
 
+    // Attach the set changes listed in a proposal, ignoring them if malformed
+    void takeSetDelta (protocol::TMProposeSet const& set,
+        LedgerProposal::ref proposal)
+    {
+        uint256 base;
+
+        if (set.has_previoustxhash ())
+        {
+            if (set.previoustxhash ().size () != (256 / 8))
+            {
+                m_journal.debug << "Proposal set delta is malformed";
+                return;
+            }
+
+            memcpy (base.begin (), set.previoustxhash ().data (), 256 / 8);
+        }
+
+        // The lists are not signed, so any peer relaying a proposal can
+        // attach them. We never send more than this, nor should anyone.
+        if ((set.addedtransactions_size () + set.removedtransactions_size ()) >
+            LedgerProposal::maxSetDelta)
+        {
+            m_journal.warning << "Proposal set delta is too large";
+            charge (Resource::feeInvalidRequest);
+            return;
+        }
+
+        std::vector <uint256> added;
+        std::vector <uint256> removed;
+
+        if (!takeHashes (set.addedtransactions (), added) ||
+            !takeHashes (set.removedtransactions (), removed))
+        {
+            m_journal.debug << "Proposal set delta is malformed";
+            return;
+        }
+
+        proposal->setDelta (base, added, removed);
+    }
+
+    static bool takeHashes (
+        google::protobuf::RepeatedPtrField <std::string> const& from,
+        std::vector <uint256>& to)
+    {
+        to.reserve (from.size ());
+
+        for (int i = 0; i < from.size (); ++i)
+        {
+            if (from.Get (i).size () != (256 / 8))
+                return false;
+
+            to.push_back (uint256 ());
+            memcpy (to.back ().begin (), from.Get (i).data (), 256 / 8);
+        }
+
+        return true;
+    }
+
     void recvHaveTxSet (protocol::TMHaveTransactionSet& packet)
     {
         uint256 hashes;
@@ -2618,8 +2689,33 @@ private:
         }
     }
 
-    static void checkTransaction (Job&, int flags, SerializedTransaction::pointer stx, boost::weak_ptr<Peer> peer)
+    // Called from our JobQueue for the first sighting of a relayed transaction
+    static void checkTransaction (Job&, OverlayImpl* pPeers, int flags, uint256 txID,
+        boost::shared_ptr <Serializer> raw, boost::weak_ptr<Peer> peer)
     {
+        SerializedTransaction::pointer stx;
+
+        try
+        {
+            stx = getApp().getMasterTransaction ().fetchParsed (txID, *raw);
+        }
+        catch (...)
+        {
+            WriteLog (lsWARNING, Peer) << "Transaction invalid: " << raw->getHex ();
+            pPeers->onMalformedTransaction ();
+            getApp().getHashRouter ().setFlag (txID, SF_BAD);
+            charge (peer, Resource::feeInvalidRequest);
+            return;
+        }
+
+        if (stx->getTransactionID () != txID)
+        {
+            // The sender used a non-canonical encoding, so the
+            // transaction must also be suppressed under its real ID.
+            if (! getApp().getHashRouter ().addSuppression (stx->getTransactionID ()))
+                return;
+        }
+
     #ifndef TRUST_NETWORK
         try
         {
@@ -63,13 +63,43 @@ Json::Value RPCHandler::doGetCounts (Json::Value params, Resource::Charge& loadT
     ret["write_load"] = getApp().getNodeStore ().getWriteLoad ();
 
     ret["SLE_hit_rate"] = getApp().getSLECache ().getHitRate ();
+    ret["SLE_index_hit_rate"] = LedgerEntryCache::getHitRate ();
     ret["node_hit_rate"] = getApp().getNodeStore ().getCacheHitRate ();
+
+    {
+        NodeStore::Database::TierStats stats;
+        getApp().getNodeStore ().getTierStats (stats);
+        ret["node_reads_fast"] = static_cast<Json::UInt> (stats.fastHits);
+        ret["node_reads_slow"] = static_cast<Json::UInt> (stats.slowHits);
+        ret["node_reads_missing"] = static_cast<Json::UInt> (stats.misses);
+        if (stats.fastSize > 0)
+            ret["node_fast_size"] = static_cast<Json::UInt> (stats.fastSize);
+    }
+    {
+        Overlay::TransactionStats stats;
+        getApp().overlay ().getTransactionStats (stats);
+        ret["relay_tx_received"] = static_cast<Json::UInt> (stats.received);
+        ret["relay_tx_suppressed"] = static_cast<Json::UInt> (stats.suppressed);
+        ret["relay_tx_malformed"] = static_cast<Json::UInt> (stats.malformed);
+    }
     ret["ledger_hit_rate"] = getApp().getLedgerMaster ().getCacheHitRate ();
     ret["AL_hit_rate"] = AcceptedLedger::getCacheHitRate ();
+    ret["tx_parses"] = static_cast<Json::UInt> (
+        getApp().getMasterTransaction ().getParseCount ());
+    ret["tx_parse_hit_rate"] = getApp().getMasterTransaction ().getParseHitRate ();
 
     ret["fullbelow_size"] = int(getApp().getFullBelowCache().size());
+    ret["proofnode_size"] = SHAMap::getProofNodeSize ();
     ret["treenode_size"] = SHAMap::getTreeNodeSize ();
 
+    ret["ledger_fetch_queue"] = getApp().getInboundLedgers ().getQueueJson ();
+
+    {
+        TrustLineGraph::pointer const graph (getApp().getPathRequests ().getGraph ());
+        if (graph)
+            ret["trust_graph"] = graph->getJson ();
+    }
+
     std::string uptime;
     int s = UptimeTimer::getInstance ().getElapsedSeconds ();
     textTime (uptime, s, "year", 365 * 24 * 60 * 60);
@@ -22,7 +22,6 @@ namespace ripple {
 
 Json::Value RPCHandler::doLedgerClosed (Json::Value, Resource::Charge& loadType, Application::ScopedLockType& masterLockHolder)
 {
-    masterLockHolder.unlock ();
     Json::Value jvResult;
 
     uint256 uLedger = mNetOps->getClosedLedgerHash ();
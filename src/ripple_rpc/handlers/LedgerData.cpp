@@ -32,8 +32,6 @@ namespace ripple {
 //     marker:       resume point, if any
 Json::Value RPCHandler::doLedgerData (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& masterLockHolder)
 {
-    masterLockHolder.unlock ();
-
     int const BINARY_PAGE_LENGTH = 256;
     int const JSON_PAGE_LENGTH = 2048;
 
@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+namespace ripple {
+
+// {
+//   ledger_hash : <ledger>
+//   ledger_index : <ledger_index>
+//   indexes : [ <index>, ... ]
+//   transactions : <bool>      // optional, prove transactions instead of state
+// }
+//
+// Returns, for each index, the hashes of the nodes from the root of the tree
+// to the item, and one copy of each node those paths pass through.
+Json::Value RPCHandler::doLedgerProof (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& masterLockHolder)
+{
+    // Most indexes a non admin may ask for at once
+    static unsigned int const maxIndexes = 256;
+
+    Ledger::pointer     lpLedger;
+    Json::Value         jvResult    = RPC::lookupLedger (params, lpLedger, *mNetOps);
+
+    if (!lpLedger)
+        return jvResult;
+
+    // A proof is only worth checking against a ledger the network agreed on
+    if (!lpLedger->isClosed () || !mNetOps->isValidated (lpLedger))
+        return RPC::make_param_error ("Ledger is not validated.");
+
+    if (!params.isMember ("indexes"))
+        return RPC::missing_field_error ("indexes");
+
+    Json::Value const& indexes = params["indexes"];
+
+    if (!indexes.isArray ())
+        return RPC::expected_field_error ("indexes", "array");
+
+    if ((indexes.size () > maxIndexes) && (mRole != Config::ADMIN))
+        return RPC::make_param_error ("Too many indexes.");
+
+    bool const bTransactions = params.isMember ("transactions") && params["transactions"].asBool ();
+    SHAMap::ref map = bTransactions
+        ? lpLedger->peekTransactionMap ()
+        : lpLedger->peekAccountStateMap ();
+
+    loadType = Resource::feeMediumBurdenRPC;
+
+    std::chrono::steady_clock::time_point const start (std::chrono::steady_clock::now ());
+
+    SHAMap::ProofNodes  nodes;
+    Json::Value         jvProofs (Json::arrayValue);
+
+    try
+    {
+        for (Json::UInt i = 0; i < indexes.size (); ++i)
+        {
+            uint256 uIndex;
+
+            if (!indexes[i].isString () || !uIndex.SetHex (indexes[i].asString ()))
+                return RPC::invalid_field_error ("indexes");
+
+            std::vector<uint256> path;
+            Json::Value& jvProof = jvProofs.append (Json::objectValue);
+
+            jvProof["index"]    = uIndex.GetHex ();
+            jvProof["present"]  = map->getProofPath (uIndex, path, nodes);
+
+            Json::Value& jvPath = (jvProof["path"] = Json::arrayValue);
+
+            BOOST_FOREACH (uint256 const& hash, path)
+                jvPath.append (hash.GetHex ());
+        }
+    }
+    catch (SHAMapMissingNode&)
+    {
+        return rpcError (rpcLGR_NOT_FOUND);
+    }
+
+    Json::Value& jvNodes = (jvResult["nodes"] = Json::objectValue);
+
+    for (SHAMap::ProofNodes::const_iterator it = nodes.begin (); it != nodes.end (); ++it)
+        jvNodes[it->first.GetHex ()] = strHex (*it->second);
+
+    jvResult["proofs"]      = jvProofs;
+    jvResult["tree_hash"]   = (bTransactions
+        ? lpLedger->getTransHash ()
+        : lpLedger->getAccountHash ()).GetHex ();
+
+    if (mRole == Config::ADMIN)
+    {
+        std::chrono::duration <double> const elapsed (
+            std::chrono::steady_clock::now () - start);
+
+        if (elapsed.count () > 0)
+            jvResult["proofs_per_second"] = indexes.size () / elapsed.count ();
+    }
+
+    return jvResult;
+}
+
+} // ripple
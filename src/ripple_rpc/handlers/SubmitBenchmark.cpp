@@ -0,0 +1,324 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012-2014 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+namespace ripple {
+
+// Latency statistics of one stage of the submission benchmark, in microseconds
+static Json::Value benchmarkStage (std::vector<std::int64_t>& samples)
+{
+    Json::Value jvStage (Json::objectValue);
+
+    jvStage["count"] = static_cast<Json::UInt> (samples.size ());
+
+    if (samples.empty ())
+        return jvStage;
+
+    std::sort (samples.begin (), samples.end ());
+
+    std::int64_t total = 0;
+
+    BOOST_FOREACH (std::int64_t sample, samples)
+        total += sample;
+
+    jvStage["total_ms"] = static_cast<Json::UInt> (total / 1000);
+    jvStage["mean_us"] = static_cast<Json::UInt> (total / samples.size ());
+    jvStage["p50_us"] = static_cast<Json::UInt> (samples[samples.size () / 2]);
+    jvStage["p99_us"] = static_cast<Json::UInt> (samples[(samples.size () * 99) / 100]);
+    jvStage["max_us"] = static_cast<Json::UInt> (samples.back ());
+
+    return jvStage;
+}
+
+static std::int64_t benchmarkMicroseconds (std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds> (
+        std::chrono::steady_clock::now () - start).count ();
+}
+
+// {
+//   transactions : <number>    // optional, defaults to 10000
+//   accounts : <number>        // optional, defaults to 100
+//   offers : <number>          // optional, percent of offers, defaults to 20
+//   ledger_size : <number>     // optional, transactions per ledger, defaults to 1000
+// }
+//
+// Stand alone only. Funds the accounts from the master account, then
+// submits signed payments and offers between them through the same path
+// as submit with a tx_blob, and accepts a ledger after every ledger_size
+// transactions. Signing is done up front and is not measured. Accepting a
+// ledger includes saving it, which stand alone does synchronously, but
+// publishing it runs on the job queue and is not measured.
+Json::Value RPCHandler::doSubmitBenchmark (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& masterLockHolder)
+{
+    if (!getConfig ().RUN_STANDALONE)
+        return rpcError (rpcNOT_STANDALONE);
+
+    masterLockHolder.unlock ();
+
+    unsigned int const txCount = params.isMember ("transactions") ? params["transactions"].asUInt () : 10000;
+    unsigned int const accountCount = params.isMember ("accounts") ? params["accounts"].asUInt () : 100;
+    unsigned int const offerPercent = params.isMember ("offers") ? params["offers"].asUInt () : 20;
+    unsigned int const ledgerSize = params.isMember ("ledger_size") ? params["ledger_size"].asUInt () : 1000;
+
+    if ((txCount == 0) || (txCount > 1000000))
+        return RPC::invalid_field_error ("transactions");
+
+    if ((accountCount < 2) || (accountCount > 10000))
+        return RPC::invalid_field_error ("accounts");
+
+    if (offerPercent > 100)
+        return RPC::invalid_field_error ("offers");
+
+    if (ledgerSize == 0)
+        return RPC::invalid_field_error ("ledger_size");
+
+    std::chrono::steady_clock::time_point const setupStart (std::chrono::steady_clock::now ());
+
+    RippleAddress const masterSeed = RippleAddress::createSeedGeneric ("masterpassphrase");
+    RippleAddress const masterGenerator = RippleAddress::createGeneratorPublic (masterSeed);
+    RippleAddress const masterPublic = RippleAddress::createAccountPublic (masterGenerator, 0);
+    RippleAddress const masterPrivate = RippleAddress::createAccountPrivate (masterGenerator, masterSeed, 0);
+
+    AccountState::pointer const masterState = mNetOps->getCurrentLedger ()->getAccountState (masterPublic);
+
+    if (!masterState)
+        return rpcError (rpcSRC_ACT_NOT_FOUND);
+
+    RippleAddress const seed = RippleAddress::createSeedGeneric ("submit_benchmark");
+    RippleAddress const generator = RippleAddress::createGeneratorPublic (seed);
+    std::vector<RippleAddress> publicKeys;
+    std::vector<RippleAddress> privateKeys;
+
+    publicKeys.reserve (accountCount);
+    privateKeys.reserve (accountCount);
+
+    for (unsigned int i = 0; i < accountCount; ++i)
+    {
+        publicKeys.push_back (RippleAddress::createAccountPublic (generator, i));
+        privateKeys.push_back (RippleAddress::createAccountPrivate (generator, seed, i));
+    }
+
+    STAmount const fee (getConfig ().FEE_DEFAULT);
+    uint160 currency;
+    STAmount::currencyFromString (currency, "USD");
+
+    // Signs a transaction and returns it as submit would receive it
+    auto finish = [&] (SerializedTransaction& tx, RippleAddress const& publicKey,
+                       RippleAddress const& privateKey, std::uint32_t sequence) -> Blob
+    {
+        tx.setSourceAccount (publicKey);
+        tx.setSequence (sequence);
+        tx.setTransactionFee (fee);
+        tx.setSigningPubKey (publicKey);
+        tx.sign (privateKey);
+
+        return tx.getSerializer ().peekData ();
+    };
+
+    // Transaction i is sent by account i % accountCount, and is an offer or a payment
+    auto isOffer = [offerPercent] (unsigned int i)
+    {
+        return ((i * 37) % 100) < offerPercent;
+    };
+
+    std::vector<std::uint64_t> offerCounts (accountCount, 0);
+    std::vector<std::uint64_t> sentCounts (accountCount, 0);
+
+    for (unsigned int i = 0; i < txCount; ++i)
+    {
+        ++sentCounts[i % accountCount];
+
+        if (isOffer (i))
+            ++offerCounts[i % accountCount];
+    }
+
+    // Each account gets the reserve for all of its offers, plus the fee and
+    // the one XRP sent or offered by each of its transactions. Payments it
+    // receives are not counted.
+    Ledger::pointer const fundingLedger (mNetOps->getCurrentLedger ());
+    std::vector<Blob> fundingBlobs;
+    std::uint32_t masterSequence = masterState->getSeq ();
+
+    for (unsigned int i = 0; i < accountCount; ++i)
+    {
+        STAmount const funding (fundingLedger->getReserve (static_cast<int> (offerCounts[i])) +
+            sentCounts[i] * (fee.getNValue () + SYSTEM_CURRENCY_PARTS));
+
+        SerializedTransaction tx (ttPAYMENT);
+        tx.setFieldAccount (sfDestination, publicKeys[i]);
+        tx.setFieldAmount (sfAmount, funding);
+        fundingBlobs.push_back (finish (tx, masterPublic, masterPrivate, masterSequence++));
+    }
+
+    std::vector<Blob> blobs;
+    std::vector<std::uint32_t> sequences;
+
+    // Signs the benchmark transactions, once the accounts are funded.
+    // The accounts remain from an earlier run, so their sequences are read.
+    auto sign = [&] ()
+    {
+        Ledger::pointer const ledger (mNetOps->getCurrentLedger ());
+
+        sequences.reserve (accountCount);
+
+        for (unsigned int i = 0; i < accountCount; ++i)
+        {
+            AccountState::pointer const state (ledger->getAccountState (publicKeys[i]));
+
+            if (!state)
+                throw std::runtime_error ("benchmark account was not funded");
+
+            sequences.push_back (state->getSeq ());
+        }
+
+        blobs.reserve (txCount);
+
+        for (unsigned int i = 0; i < txCount; ++i)
+        {
+            unsigned int const from = i % accountCount;
+
+            if (isOffer (i))
+            {
+                // Offers to buy USD for XRP at varying rates, which never cross
+                SerializedTransaction tx (ttOFFER_CREATE);
+                tx.setFieldAmount (sfTakerPays, STAmount (currency, masterPublic.getAccountID (), 1 + (i % 1000)));
+                tx.setFieldAmount (sfTakerGets, STAmount (SYSTEM_CURRENCY_PARTS));
+                blobs.push_back (finish (tx, publicKeys[from], privateKeys[from], sequences[from]++));
+            }
+            else
+            {
+                unsigned int to = (from * 7 + 1 + i / accountCount) % accountCount;
+
+                if (to == from)
+                    to = (from + 1) % accountCount;
+
+                SerializedTransaction tx (ttPAYMENT);
+                tx.setFieldAccount (sfDestination, publicKeys[to]);
+                tx.setFieldAmount (sfAmount, STAmount (SYSTEM_CURRENCY_PARTS));
+                blobs.push_back (finish (tx, publicKeys[from], privateKeys[from], sequences[from]++));
+            }
+        }
+    };
+
+    std::vector<std::int64_t> parseSamples;
+    std::vector<std::int64_t> applySamples;
+    std::vector<std::int64_t> acceptSamples;
+    std::map<TER, unsigned int> results;
+
+    // Parses and submits one transaction, as submit does with a tx_blob
+    auto submit = [&] (Blob const& blob, bool measure)
+    {
+        std::chrono::steady_clock::time_point start (std::chrono::steady_clock::now ());
+
+        Serializer sTrans (blob);
+        SerializerIterator sitTrans (sTrans);
+        SerializedTransaction::pointer stpTrans (boost::make_shared<SerializedTransaction> (boost::ref (sitTrans)));
+        Transaction::pointer tpTrans (boost::make_shared<Transaction> (stpTrans, false));
+
+        if (measure)
+            parseSamples.push_back (benchmarkMicroseconds (start));
+
+        start = std::chrono::steady_clock::now ();
+        mNetOps->processTransaction (tpTrans, true, true, false);
+
+        if (measure)
+        {
+            applySamples.push_back (benchmarkMicroseconds (start));
+            ++results[tpTrans->getResult ()];
+        }
+    };
+
+    // Closes the open ledger, as ledger_accept does
+    auto accept = [&] (bool measure)
+    {
+        std::chrono::steady_clock::time_point const start (std::chrono::steady_clock::now ());
+
+        {
+            Application::ScopedLockType lock (getApp ().getMasterLock ());
+            mNetOps->acceptLedger ();
+        }
+
+        if (measure)
+            acceptSamples.push_back (benchmarkMicroseconds (start));
+    };
+
+    loadType = Resource::feeHighBurdenRPC;
+
+    Json::Value jvResult (Json::objectValue);
+
+    try
+    {
+        BOOST_FOREACH (Blob const& blob, fundingBlobs)
+            submit (blob, false);
+
+        accept (false);
+
+        sign ();
+
+        jvResult["setup_ms"] = static_cast<Json::UInt> (benchmarkMicroseconds (setupStart) / 1000);
+
+        std::chrono::steady_clock::time_point const start (std::chrono::steady_clock::now ());
+
+        for (unsigned int i = 0; i < txCount; ++i)
+        {
+            submit (blobs[i], true);
+
+            if ((((i + 1) % ledgerSize) == 0) || ((i + 1) == txCount))
+                accept (true);
+        }
+
+        std::int64_t const elapsed = benchmarkMicroseconds (start);
+
+        jvResult["transactions"] = txCount;
+        jvResult["accounts"] = accountCount;
+        jvResult["ledgers"] = static_cast<Json::UInt> (acceptSamples.size ());
+        jvResult["elapsed_ms"] = static_cast<Json::UInt> (elapsed / 1000);
+        jvResult["tx_per_second"] = (elapsed > 0) ? (txCount * 1000000.0 / elapsed) : 0.0;
+    }
+    catch (std::exception& e)
+    {
+        jvResult["error"] = "internalSubmit";
+        jvResult["error_exception"] = e.what ();
+
+        return jvResult;
+    }
+
+    Json::Value& jvResults = (jvResult["results"] = Json::objectValue);
+
+    for (std::map<TER, unsigned int>::const_iterator it = results.begin (); it != results.end (); ++it)
+    {
+        std::string sToken;
+        std::string sHuman;
+
+        transResultInfo (it->first, sToken, sHuman);
+        jvResults[sToken] = it->second;
+    }
+
+    Json::Value& jvStages = (jvResult["stages"] = Json::objectValue);
+
+    jvStages["parse"] = benchmarkStage (parseSamples);
+    jvStages["apply"] = benchmarkStage (applySamples);
+    jvStages["accept"] = benchmarkStage (acceptSamples);
+    jvStages["accept"]["includes"] = "close and save";
+    jvStages["accept"]["excludes"] = "publish, which runs on the job queue";
+
+    return jvResult;
+}
+
+} // ripple
@@ -27,8 +27,6 @@ namespace ripple {
 // XXX In this case, not specify either ledger does not mean ledger current. It means any ledger.
 Json::Value RPCHandler::doTransactionEntry (Json::Value params, Resource::Charge& loadType, Application::ScopedLockType& masterLockHolder)
 {
-    masterLockHolder.unlock ();
-
     Ledger::pointer     lpLedger;
     Json::Value         jvResult    = RPC::lookupLedger (params, lpLedger, *mNetOps);
 
@@ -45,16 +45,59 @@ Json::Value RPCHandler::doTxHistory (Json::Value params, Resource::Charge& loadT
         boost::str (boost::format ("SELECT * FROM Transactions ORDER BY LedgerSeq desc LIMIT %u,20")
                     % startIndex);
 
+    // The columns of each row are copied while holding the database lock.
+    // Transactions kept only in their ledger are loaded after releasing it.
+    struct Row
+    {
+        std::string     transID;
+        std::uint32_t   ledgerSeq;
+        std::string     status;
+        Blob            rawTxn;
+    };
+
+    std::vector<Row> rows;
+
     {
         Database* db = getApp().getTxnDB ()->getDB ();
         DeprecatedScopedLock sl (getApp().getTxnDB ()->getDBLock ());
 
         SQL_FOREACH (db, sql)
         {
-            Transaction::pointer trans = Transaction::transactionFromSQL (db, false);
+            Row row;
+
+            db->getStr ("TransID", row.transID);
+            row.ledgerSeq = db->getInt ("LedgerSeq");
+            db->getStr ("Status", row.status);
+
+            int txSize = 2048;
+            row.rawTxn.resize (txSize);
+            txSize = db->getBinary ("RawTxn", &row.rawTxn[0], row.rawTxn.size ());
+
+            if (txSize > row.rawTxn.size ())
+            {
+                row.rawTxn.resize (txSize);
+                db->getBinary ("RawTxn", &row.rawTxn[0], row.rawTxn.size ());
+            }
+            else
+                row.rawTxn.resize (txSize);
+
+            rows.push_back (row);
+        }
+    }
+
+    BOOST_FOREACH (Row& row, rows)
+    {
+        if (row.rawTxn.empty ())
+        {
+            Blob meta;
 
-            if (trans) txs.append (trans->getJson (0));
+            if (!Ledger::loadTransactionBlobs (row.ledgerSeq, uint256 (row.transID), row.rawTxn, meta))
+                continue;
         }
+
+        Transaction::pointer trans = Transaction::transactionFromBlob (row.rawTxn, row.status, row.ledgerSeq, false);
+
+        txs.append (trans->getJson (0));
     }
 
     obj["txs"] = txs;
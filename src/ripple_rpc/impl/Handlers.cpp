@@ -39,6 +39,7 @@
 #include "../handlers/LedgerData.cpp"
 #include "../handlers/LedgerEntry.cpp"
 #include "../handlers/LedgerHeader.cpp"
+#include "../handlers/LedgerProof.cpp"
 #include "../handlers/LogLevel.cpp"
 #include "../handlers/LogRotate.cpp"
 #include "../handlers/NicknameInfo.cpp"
@@ -59,6 +60,7 @@
 #include "../handlers/Sign.cpp"
 #include "../handlers/Stop.cpp"
 #include "../handlers/Submit.cpp"
+#include "../handlers/SubmitBenchmark.cpp"
 #include "../handlers/Subscribe.cpp"
 #include "../handlers/TransactionEntry.cpp"
 #include "../handlers/Tx.cpp"